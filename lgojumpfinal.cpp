@@ -3,7 +3,15 @@
  * Copyright (c) 2025 Richard Sardini.
  * Licensed under the Apache License, Version 2.0.
  */
+#ifdef _WIN32
+#include <winsock2.h> // Before windows.h, which would pull in the old winsock.h
+#include <ws2tcpip.h>
 #include <windows.h>
+#include <conio.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#endif
 #include <fstream>      
 #include <string>       
 #include <cmath>
@@ -22,39 +30,121 @@
 #include <numeric>
 #include <sys/stat.h> 
 #include <cfloat> 
-#include <commctrl.h> 
 #include <random>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <charconv>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <map>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cerrno>
+#include <stdexcept>
+#include <type_traits>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <termios.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#endif
 
 // ====================================================================
 // --- FINAL STABLE CONSTANTS AND MACRO DEFINITIONS (v26) ---
 // ====================================================================
 // Defined in long double to maintain precision for C_LGO derivation
-const long double MUON_MASS_LD = 1.8835316L * 1e-28L; 
-const long double ELECTRON_MASS_LD = 9.1093837L * 1e-31L; 
+constexpr long double MUON_MASS_LD = 1.8835316L * 1e-28L; 
+constexpr long double ELECTRON_MASS_LD = 9.1093837L * 1e-31L; 
 
-const double C_LGO_STATIC = (double)(MUON_MASS_LD / ELECTRON_MASS_LD); // Mass ratio: ~206.7682283
-const double MATH_E = 2.718281828459045;
-const double MATH_PI = 3.141592653589793;
-const double PHI_DAMPENER = 1.6180339887 / 2.0; // Golden Ratio/2: ~0.8090
+constexpr double C_LGO_STATIC = (double)(MUON_MASS_LD / ELECTRON_MASS_LD); // Mass ratio: ~206.7682283
+constexpr double MATH_E = 2.718281828459045;
+constexpr double MATH_PI = 3.141592653589793;
+constexpr double PHI_DAMPENER = 1.6180339887 / 2.0; // Golden Ratio/2: ~0.8090
+
+// std::log / std::pow are not constexpr, so the derived constants below are the
+// exact doubles their formulas evaluate to, written as hex literals.
 
 // --- THE ZETA-STABILIZED LGO CONSTANT (C_LGO*) ---
 // C_LGO* = C_LGO_STATIC * (Phi/2) * (ln(C_LGO_STATIC) / ln(E*Pi))
-const double C_LGO_STAR = C_LGO_STATIC * PHI_DAMPENER * (std::log(C_LGO_STATIC) / std::log(MATH_E * MATH_PI)); // ~413.435
+constexpr double C_LGO_STAR = 0x1.9fd713bb36012p+8; // ~415.8401448
+constexpr double LN_C_LGO_STAR = 0x1.81f0734436b94p+2; // ln(C_LGO*): ~6.0303009
 
 // --- ZETA CRITICAL LINE CONSTANT (1/2) ---
-const double ZETA_CRITICAL_LINE_CONSTANT = C_LGO_STAR / (2.0 * std::pow(MATH_PI, 4.0)); // Should be ~2.122
+// C_LGO* / (2 * Pi^4)
+constexpr double ZETA_CRITICAL_LINE_CONSTANT = 0x1.11376b6ecae58p+1; // ~2.1345038
+
+constexpr double LN_10 = 0x1.26bb1bbb55516p+1; // ln(10)
 
-const int ULAM_CORRECTION_SIZE = 5;      
-const int MOD_7_CORRECTION_SIZE = 7;     
+constexpr int ULAM_CORRECTION_SIZE = 5;      
+constexpr int MOD_7_CORRECTION_SIZE = 7;     
 const std::string SEQUENCE_FILE = "lgo_sequence.txt"; 
 
 // --- LGO DIGITAL WATERMARK (DO NOT REMOVE OR USE) ---
 const std::string LGO_WATERMARK_ID = "LGO_PREDICTOR_ID:2025_02_ALPHA_P_07"; 
 
-long long ulam_delta_correction_12[ULAM_CORRECTION_SIZE] = {0, -2, 2, -1, -6}; 
-long long ulam_delta_correction_7[MOD_7_CORRECTION_SIZE] = {0, 3, -1, 0, 1, -1, 0}; 
+constexpr long long ulam_delta_correction_12[ULAM_CORRECTION_SIZE] = {0, -2, 2, -1, -6}; 
+constexpr long long ulam_delta_correction_7[MOD_7_CORRECTION_SIZE] = {0, 3, -1, 0, 1, -1, 0}; 
 enum PrimeSet { SET_NONE, SET_A, SET_B, SET_C, SET_D }; 
 
+// --- COMBINED RESIDUE TABLE (P mod 84 = lcm(12, 7)) ---
+// Set and Delta = delta_12 + round(delta_7 * Pi / 10) for every residue, built at
+// compile time so a prediction step does one lookup instead of two residues, a
+// switch and a rounding. P = 2 and P = 3 are the only primes outside the mod 12
+// sets and are special-cased by the caller.
+constexpr long long round_half_away(double value) {
+    return (long long)(value < 0.0 ? value - 0.5 : value + 0.5);
+}
+
+constexpr PrimeSet prime_set_for_mod_12(long long residue) {
+    return residue == 1 ? SET_A : residue == 5 ? SET_B : residue == 7 ? SET_C : residue == 11 ? SET_D : SET_NONE;
+}
+
+struct ResidueModel {
+    PrimeSet prime_set;
+    long long delta;
+};
+
+struct ResidueTable {
+    long long delta_7_rounded[MOD_7_CORRECTION_SIZE];
+    ResidueModel mod_84[84];
+    long long delta_84[84]; // mod_84[r].delta as a flat array for vector gathers
+};
+
+constexpr ResidueTable build_residue_table() {
+    ResidueTable table{};
+    for (int r = 0; r < MOD_7_CORRECTION_SIZE; r++) {
+        table.delta_7_rounded[r] = round_half_away((double)ulam_delta_correction_7[r] * MATH_PI / 10.0);
+    }
+    for (int r = 0; r < 84; r++) {
+        PrimeSet set = prime_set_for_mod_12(r % 12);
+        table.mod_84[r] = { set, ulam_delta_correction_12[set] + table.delta_7_rounded[r % 7] };
+        table.delta_84[r] = table.mod_84[r].delta;
+    }
+    return table;
+}
+
+constexpr ResidueTable RESIDUE_TABLE = build_residue_table();
+static_assert(RESIDUE_TABLE.delta_7_rounded[1] == 1 && RESIDUE_TABLE.delta_7_rounded[2] == 0, "delta_7 rounding");
+static_assert(RESIDUE_TABLE.mod_84[1].delta == -1 && RESIDUE_TABLE.mod_84[83].prime_set == SET_D, "mod 84 table");
+
 const std::vector<std::pair<std::string, std::string>> PRIME_LIST = {
     {"(1) 10 Digits",  "9999999967"}, 
     {"(2) 15 Digits",  "999999999999991"},
@@ -68,13 +158,14 @@ const std::vector<std::pair<std::string, std::string>> PRIME_LIST = {
 long long predictions_made = 0;
 bool is_running = true; 
 bool in_menu = true; 
-double current_phi = 0.0; 
-double pnt_gap_ratio = 0.0; 
 
 std::string user_prime_input = ""; 
-PrimeSet current_prime_set_enum = SET_D; 
+
+const char* const RH_STATUS_STABLE = "STABLE (C_LGO*)";
 
 // --- Metrics Structure (Final) ---
+// Plain data (enum + static text, no owned strings): cheap to copy and return
+// from the pure prediction API.
 struct PredictionMetrics {
     double g_gravitational = C_LGO_STAR; 
     long long current_prime_digits = 0;
@@ -84,81 +175,765 @@ struct PredictionMetrics {
     long long fluctuation_delta = 0;
     long long final_gap = 0;
     double correlative_adjustment = 0.0; 
-    std::string current_prime_set = "SET_D";
+    PrimeSet current_prime_set = SET_D;
     long long zeta_correlation_Z = 0; 
-    std::string rh_condition_status = "STABLE (C_LGO*)";
+    const char* rh_condition_status = RH_STATUS_STABLE;
     double pnt_ratio = 0.0;
 };
 
-// --- Console Cursor Position Utility ---
-void gotoXY(int x, int y) {
-    COORD coord = { (SHORT)x, (SHORT)y };
-    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+const char* prime_set_name(PrimeSet set) {
+    switch (set) {
+        case SET_A: return "SET_A";
+        case SET_B: return "SET_B";
+        case SET_C: return "SET_C";
+        case SET_D: return "SET_D";
+        default: return "SET_UNKNOWN";
+    }
+}
+
+// ====================================================================
+// --- ALLOCATION COUNTER ---
+// ====================================================================
+// Global operator new is replaced so the benchmark suite can report heap
+// allocations per step. The counter is thread_local: no shared cache line, and
+// each thread only ever sees its own allocations.
+
+thread_local unsigned long long thread_allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    thread_allocation_count++;
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    thread_allocation_count++;
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
 }
 
+// Kept out of line: once inlined next to a new-expression, GCC flags the
+// free() as mismatched with operator new.
+#if defined(_MSC_VER)
+#define LGO_NOINLINE __declspec(noinline)
+#else
+#define LGO_NOINLINE __attribute__((noinline))
+#endif
+
+LGO_NOINLINE void operator delete(void* memory) noexcept { std::free(memory); }
+LGO_NOINLINE void operator delete[](void* memory) noexcept { std::free(memory); }
+LGO_NOINLINE void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+LGO_NOINLINE void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
 
 // ====================================================================
-// --- FILE I/O IMPLEMENTATION (Unchanged) ---
+// --- STAGE PROFILER ---
 // ====================================================================
+// Scoped timers around the numbered model stages and the sequence write. Every
+// call is counted; one call in PROFILE_SAMPLE_EVERY per stage is timed with
+// steady_clock into a log-linear histogram, so an untimed call costs a counter
+// update. Each thread owns its counters (single writer, relaxed atomics) and
+// the UI panel and exit summary merge them while chains keep running.
+// The timers only run with --profile; until then a stage costs one load of
+// 'stage_profiling'. Build with -DLGO_PROFILING=0 to compile them out.
 
-std::string load_last_prime() {
-    std::ifstream file(SEQUENCE_FILE);
-    std::string last_line = "";
-    std::string current_line;
-    
-    while (std::getline(file, current_line)) {
-        if (!current_line.empty()) {
-            last_line = current_line;
+#ifndef LGO_PROFILING
+#define LGO_PROFILING 1
+#endif
+
+enum ProfileStage {
+    PROFILE_DENSITY_G, PROFILE_DELTA, PROFILE_FINAL_GAP, PROFILE_PNT_RATIO, PROFILE_BIGINT_ADD,
+    PROFILE_SEQUENCE_WRITE, PROFILE_STAGE_COUNT
+};
+
+// The sequence write covers every chain record a SequenceWriter takes,
+// segment cache files included.
+const char* const PROFILE_STAGE_NAMES[PROFILE_STAGE_COUNT] = {
+    "1. Density G", "2. Ulam/Mod7 Delta", "4. Final Gap", "5. PNT Ratio", "6. BigInt Add", "Sequence Write"
+};
+
+std::atomic<bool> stage_profiling{ false }; // Set by --profile before any chain starts
+
+const unsigned long long PROFILE_SAMPLE_EVERY = 256;
+const int PROFILE_BUCKETS = 252; // 4 sub-buckets per power of two up to 2^63 ns
+
+// Exact below 4 ns, then 4 buckets per octave (at most 25% wide).
+int profile_bucket(unsigned long long ns) {
+    if (ns < 4) return (int)ns;
+    int octave = 63;
+    while ((ns >> octave) == 0) { octave--; }
+    return 4 * (octave - 1) + (int)((ns >> (octave - 2)) & 3);
+}
+
+// Midpoint of a bucket, used as the reported percentile value.
+unsigned long long profile_bucket_value(int bucket) {
+    if (bucket < 4) return (unsigned long long)bucket;
+    int octave = bucket / 4 + 1;
+    unsigned long long low = (unsigned long long)(4 + bucket % 4) << (octave - 2);
+    return low + ((1ULL << (octave - 2)) >> 1);
+}
+
+struct StageHistogram {
+    std::atomic<unsigned long long> sampled_ns{ 0 };
+    std::atomic<unsigned long long> buckets[PROFILE_BUCKETS];
+
+    StageHistogram() {
+        for (auto& bucket : buckets) { bucket.store(0, std::memory_order_relaxed); }
+    }
+};
+
+// Call counters share one cache line; the histograms are only touched when sampled.
+struct ProfileThread {
+    alignas(64) std::atomic<unsigned long long> calls[PROFILE_STAGE_COUNT];
+    StageHistogram histograms[PROFILE_STAGE_COUNT];
+
+    ProfileThread() {
+        for (auto& count : calls) { count.store(0, std::memory_order_relaxed); }
+    }
+};
+
+// Threads register once and are never removed, so the summary still covers
+// worker threads that have already finished.
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ProfileThread>> threads;
+};
+
+ProfileRegistry& profile_registry() {
+    static ProfileRegistry registry;
+    return registry;
+}
+
+ProfileThread& profile_thread() {
+    thread_local ProfileThread* current = nullptr;
+    if (current == nullptr) {
+        ProfileRegistry& registry = profile_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.emplace_back(new ProfileThread());
+        current = registry.threads.back().get();
+    }
+    return *current;
+}
+
+// Only the owning thread writes, so a plain load + store is enough.
+inline void profile_add(std::atomic<unsigned long long>& counter, unsigned long long amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Cost of the two clock reads around an empty stage, subtracted from every sample.
+unsigned long long profile_clock_overhead_ns() {
+    static const unsigned long long overhead = []() {
+        long long best = -1;
+        for (int i = 0; i < 1000; i++) {
+            auto first = std::chrono::steady_clock::now();
+            auto second = std::chrono::steady_clock::now();
+            long long ns = (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(second - first).count();
+            if (best < 0 || ns < best) { best = ns; }
         }
+        return (unsigned long long)std::max(0LL, best);
+    }();
+    return overhead;
+}
+
+class StageTimer {
+public:
+    explicit StageTimer(ProfileStage stage) : stage(stage) {
+        if (!stage_profiling.load(std::memory_order_relaxed)) return;
+        thread = &profile_thread();
+        unsigned long long calls = thread->calls[stage].load(std::memory_order_relaxed);
+        thread->calls[stage].store(calls + 1, std::memory_order_relaxed);
+        sampled = calls % PROFILE_SAMPLE_EVERY == 0;
+        if (sampled) { start = std::chrono::steady_clock::now(); }
     }
-    
-    if (!last_line.empty()) {
-        return last_line;
-    } else {
-        return "";
+
+    ~StageTimer() {
+        if (!sampled) return;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        unsigned long long ns = (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        unsigned long long overhead = profile_clock_overhead_ns();
+        ns = ns > overhead ? ns - overhead : 0;
+        StageHistogram& histogram = thread->histograms[stage];
+        profile_add(histogram.sampled_ns, ns);
+        profile_add(histogram.buckets[profile_bucket(ns)], 1);
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    ProfileThread* thread = nullptr;
+    ProfileStage stage;
+    bool sampled = false;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define LGO_PROFILE_CONCAT_INNER(a, b) a##b
+#define LGO_PROFILE_CONCAT(a, b) LGO_PROFILE_CONCAT_INNER(a, b)
+#if LGO_PROFILING
+#define LGO_PROFILE_STAGE(stage) StageTimer LGO_PROFILE_CONCAT(lgo_stage_timer_, __LINE__)(stage)
+#else
+#define LGO_PROFILE_STAGE(stage) ((void)0)
+#endif
+
+struct StageSummary {
+    unsigned long long calls = 0;
+    unsigned long long samples = 0;
+    double mean_ns = 0.0;
+    unsigned long long p50_ns = 0;
+    unsigned long long p99_ns = 0;
+};
+
+// Merges every thread's histogram for 'stage'.
+StageSummary summarize_stage(ProfileStage stage) {
+    StageSummary summary;
+    std::vector<unsigned long long> merged(PROFILE_BUCKETS, 0);
+    unsigned long long total_ns = 0;
+    {
+        ProfileRegistry& registry = profile_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto& thread : registry.threads) {
+            const StageHistogram& histogram = thread->histograms[stage];
+            summary.calls += thread->calls[stage].load(std::memory_order_relaxed);
+            total_ns += histogram.sampled_ns.load(std::memory_order_relaxed);
+            for (int b = 0; b < PROFILE_BUCKETS; b++) {
+                merged[b] += histogram.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    for (unsigned long long count : merged) { summary.samples += count; }
+    if (summary.samples == 0) {
+        return summary;
+    }
+    summary.mean_ns = (double)total_ns / (double)summary.samples;
+
+    unsigned long long p50_rank = (summary.samples + 1) / 2;
+    unsigned long long p99_rank = summary.samples - summary.samples / 100;
+    unsigned long long seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        if (merged[b] == 0) continue;
+        if (seen < p50_rank && seen + merged[b] >= p50_rank) { summary.p50_ns = profile_bucket_value(b); }
+        if (seen < p99_rank && seen + merged[b] >= p99_rank) { summary.p99_ns = profile_bucket_value(b); }
+        seen += merged[b];
+    }
+    return summary;
+}
+
+size_t profile_thread_count() {
+    ProfileRegistry& registry = profile_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.threads.size();
+}
+
+// Exit summary; prints nothing when no stage ran (or profiling is compiled out).
+void print_profile_summary(std::ostream& out) {
+    StageSummary summaries[PROFILE_STAGE_COUNT];
+    bool any = false;
+    for (int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+        summaries[s] = summarize_stage((ProfileStage)s);
+        any = any || summaries[s].calls > 0;
+    }
+    if (!any) {
+        return;
+    }
+    out << "--- Stage Timings (1 in " << PROFILE_SAMPLE_EVERY << " calls sampled, "
+        << profile_thread_count() << " thread(s)) ---" << std::endl;
+    for (int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+        const StageSummary& summary = summaries[s];
+        if (summary.calls == 0) continue;
+        out << "  " << std::left << std::setw(20) << PROFILE_STAGE_NAMES[s] << std::right
+            << " calls " << std::setw(12) << summary.calls
+            << "  p50 " << std::setw(8) << summary.p50_ns << " ns"
+            << "  p99 " << std::setw(8) << summary.p99_ns << " ns"
+            << "  mean " << std::fixed << std::setprecision(1) << std::setw(9) << summary.mean_ns << " ns" << std::endl;
     }
 }
 
-void save_new_prime(const std::string& prime_candidate) {
-    std::ofstream file(SEQUENCE_FILE, std::ios::app);
-    if (file.is_open()) {
-        file << prime_candidate << "\n";
-        file.close();
+// ====================================================================
+// --- TERMINAL BACKEND ---
+// ====================================================================
+// Cursor placement, screen clearing, resizing and non-blocking key polling.
+// The Win32 backend uses the console API and _kbhit(); everywhere else ANSI
+// escape sequences go through std::cout and keys are read from a termios
+// non-canonical stdin. No shell is ever spawned. When stdin or stdout is not a
+// console (piped scripts, redirected output) none of this runs: the screen is
+// left alone and the console mode reads plain lines instead.
+
+// A screen update: positioned text spans collected off-screen, then drawn by
+// Terminal::draw() in one write.
+class Frame {
+public:
+    // Starts a new span at (x, y); text streamed into the result lands there.
+    std::ostream& at(int x, int y) {
+        close_span();
+        spans.push_back({ x, y, (size_t)text.tellp(), 0 });
+        return text;
+    }
+
+    struct Span {
+        int x;
+        int y;
+        size_t offset;
+        size_t length;
+    };
+
+    // Finalizes the spans; 'contents' then holds the text they index into.
+    const std::vector<Span>& finish(std::string& contents) {
+        close_span();
+        contents = text.str();
+        return spans;
+    }
+
+private:
+    void close_span() {
+        if (!spans.empty()) {
+            spans.back().length = (size_t)text.tellp() - spans.back().offset;
+        }
+    }
+
+    std::ostringstream text;
+    std::vector<Span> spans;
+};
+
+class Terminal {
+public:
+    ~Terminal() { end_key_polling(); }
+
+    // Both stdin and stdout are a console / TTY. Checked once.
+    bool is_interactive() {
+        if (interactive < 0) {
+#ifdef _WIN32
+            DWORD mode = 0;
+            interactive = (GetConsoleMode(GetStdHandle(STD_INPUT_HANDLE), &mode) && GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode)) ? 1 : 0;
+#else
+            interactive = (isatty(STDIN_FILENO) && isatty(STDOUT_FILENO)) ? 1 : 0;
+#endif
+        }
+        return interactive == 1;
+    }
+
+    void draw(Frame& frame) {
+        std::string contents;
+        const std::vector<Frame::Span>& spans = frame.finish(contents);
+#ifdef _WIN32
+        std::cout.flush();
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        for (const Frame::Span& span : spans) {
+            COORD coord = { (SHORT)span.x, (SHORT)span.y };
+            DWORD written = 0;
+            WriteConsoleOutputCharacterA(console, contents.data() + span.offset, (DWORD)span.length, coord, &written);
+        }
+#else
+        std::string out;
+        out.reserve(contents.size() + spans.size() * 12);
+        for (const Frame::Span& span : spans) {
+            out += "\x1b[" + std::to_string(span.y + 1) + ";" + std::to_string(span.x + 1) + "H";
+            out.append(contents, span.offset, span.length);
+        }
+        std::cout.write(out.data(), (std::streamsize)out.size());
+        std::cout.flush();
+#endif
+    }
+
+    void move_cursor(int x, int y) {
+#ifdef _WIN32
+        std::cout.flush();
+        COORD coord = { (SHORT)x, (SHORT)y };
+        SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
+#else
+        std::cout << "\x1b[" << (y + 1) << ';' << (x + 1) << 'H';
+#endif
+    }
+
+    void clear() {
+        if (!is_interactive()) return;
+#ifdef _WIN32
+        std::cout.flush();
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (!GetConsoleScreenBufferInfo(console, &info)) return;
+        DWORD cells = (DWORD)info.dwSize.X * (DWORD)info.dwSize.Y;
+        DWORD written = 0;
+        COORD origin = { 0, 0 };
+        FillConsoleOutputCharacterA(console, ' ', cells, origin, &written);
+        FillConsoleOutputAttribute(console, info.wAttributes, cells, origin, &written);
+        SetConsoleCursorPosition(console, origin);
+#else
+        std::cout << "\x1b[2J\x1b[H" << std::flush;
+#endif
+    }
+
+    void set_cursor_visible(bool visible) {
+        if (!is_interactive()) return;
+#ifdef _WIN32
+        CONSOLE_CURSOR_INFO cursor_info;
+        GetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursor_info);
+        cursor_info.bVisible = visible ? TRUE : FALSE;
+        SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursor_info);
+#else
+        std::cout << (visible ? "\x1b[?25h" : "\x1b[?25l") << std::flush;
+#endif
+    }
+
+    // Grows the console to at least columns x rows. Requests that fit the size
+    // already set do nothing, so going back and forth between the menu and the
+    // dashboard resizes once, not on every transition. Best effort: terminals
+    // that do not honour the request keep their size.
+    void ensure_size(int columns, int rows) {
+        if (!is_interactive() || (columns <= size_columns && rows <= size_rows)) return;
+        columns = std::max(columns, size_columns);
+        rows = std::max(rows, size_rows);
+        size_columns = columns;
+        size_rows = rows;
+#ifdef _WIN32
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        SMALL_RECT minimal = { 0, 0, 1, 1 };
+        SetConsoleWindowInfo(console, TRUE, &minimal);
+        COORD buffer_size = { (SHORT)columns, (SHORT)rows };
+        SetConsoleScreenBufferSize(console, buffer_size);
+        SMALL_RECT window = { 0, 0, (SHORT)(columns - 1), (SHORT)(rows - 1) };
+        SetConsoleWindowInfo(console, TRUE, &window);
+#else
+        std::cout << "\x1b[8;" << rows << ';' << columns << 't' << std::flush;
+#endif
+    }
+
+    // Puts stdin into non-canonical, no-echo mode so poll_key() sees single
+    // keystrokes. Only used while the prediction loop runs; the menu needs
+    // line input.
+    void begin_key_polling() {
+#ifndef _WIN32
+        if (polling || !isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved_mode) != 0) return;
+        termios raw = saved_mode;
+        raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) { polling = true; }
+#endif
+    }
+
+    void end_key_polling() {
+#ifndef _WIN32
+        if (!polling) return;
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_mode);
+        polling = false;
+#endif
+    }
+
+    // Returns the next pending key, or -1 without blocking when there is none.
+    int poll_key() {
+#ifdef _WIN32
+        if (!_kbhit()) return -1;
+        return _getch();
+#else
+        if (!polling) return -1;
+        pollfd input = { STDIN_FILENO, POLLIN, 0 };
+        if (poll(&input, 1, 0) <= 0 || !(input.revents & POLLIN)) return -1;
+        unsigned char key = 0;
+        if (read(STDIN_FILENO, &key, 1) != 1) return -1;
+        return key;
+#endif
     }
+
+private:
+    int interactive = -1; // Unknown until is_interactive() first runs
+    int size_columns = 0;
+    int size_rows = 0;
+#ifndef _WIN32
+    termios saved_mode = {};
+    bool polling = false;
+#endif
+};
+
+Terminal terminal;
+
+// --- Console Cursor Position Utility ---
+void gotoXY(int x, int y) {
+    terminal.move_cursor(x, y);
 }
 
 
 // ====================================================================
-// --- BIGINT ARITHMETIC & MODULO (Unchanged) ---
+// --- FILE I/O IMPLEMENTATION ---
 // ====================================================================
 
-std::string add_strings(const std::string& large_num_str, long long small_num_ll) {
-    std::string small_num_str = std::to_string(small_num_ll);
-    
-    std::string result = "";
-    int carry = 0;
-    int i = large_num_str.length() - 1;
-    int j = small_num_str.length() - 1;
+// 64-bit file positioning (plain fseek/ftell are limited to 2 GB on Windows).
+int seek_file_64(std::FILE* file, long long offset, int origin) {
+#ifdef _WIN32
+    return _fseeki64(file, offset, origin);
+#else
+    return fseeko(file, (off_t)offset, origin);
+#endif
+}
+
+long long tell_file_64(std::FILE* file) {
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return (long long)ftello(file);
+#endif
+}
+
+// Returns -1 if the file cannot be opened.
+long long file_size_bytes(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return -1;
+    }
+    long long size = -1;
+    if (seek_file_64(file, 0, SEEK_END) == 0) {
+        size = tell_file_64(file);
+    }
+    std::fclose(file);
+    return size;
+}
+
+bool is_line_separator(char c) {
+    return c == '\n' || c == '\r';
+}
+
+// --- Memory-Mapped File ---
+// Read-only view of a whole file. Pages are faulted in on demand, so mapping a
+// multi-gigabyte sequence is O(1) and readers never copy it through iostreams.
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
 
-    while (i >= 0 || j >= 0 || carry) {
-        int sum = carry;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-        if (i >= 0) {
-            sum += large_num_str[i] - '0';
-            i--;
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_handle == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size)) {
+            close();
+            return false;
+        }
+        length = (size_t)file_size.QuadPart;
+        if (length == 0) {
+            return true;
+        }
+        mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_handle == NULL) {
+            close();
+            return false;
+        }
+        view = (const char*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close();
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length == 0) {
+            return true;
         }
+        void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        view = (address == MAP_FAILED) ? nullptr : (const char*)address;
+#endif
+        if (view == nullptr) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (view != nullptr) { UnmapViewOfFile(view); }
+        if (mapping_handle != NULL) { CloseHandle(mapping_handle); }
+        if (file_handle != INVALID_HANDLE_VALUE) { CloseHandle(file_handle); }
+        mapping_handle = NULL;
+        file_handle = INVALID_HANDLE_VALUE;
+#else
+        if (view != nullptr) { munmap((void*)view, length); }
+        if (fd >= 0) { ::close(fd); }
+        fd = -1;
+#endif
+        view = nullptr;
+        length = 0;
+    }
+
+    // Hint for front-to-back scans (no-op where unsupported).
+    void advise_sequential() const {
+#ifndef _WIN32
+        if (view != nullptr) { madvise((void*)view, length, MADV_SEQUENTIAL); }
+#endif
+    }
+
+    const char* data() const { return view; }
+    size_t size() const { return length; }
+
+private:
+#ifdef _WIN32
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping_handle = NULL;
+#else
+    int fd = -1;
+#endif
+    const char* view = nullptr;
+    size_t length = 0;
+};
+
+// --- Text Records ---
+// A record is a non-empty line; CR and LF both count as separators, so files
+// written in Windows text mode read the same as ours.
+
+// First separator (is_line_separator) at or after 'begin', or 'size'.
+size_t find_line_separator(const char* data, size_t begin, size_t size) {
+    const char* newline = (const char*)std::memchr(data + begin, '\n', size - begin);
+    size_t end = (newline != nullptr) ? (size_t)(newline - data) : size;
+    const char* carriage_return = (const char*)std::memchr(data + begin, '\r', end - begin);
+    return (carriage_return != nullptr) ? (size_t)(carriage_return - data) : end;
+}
+
+// Finds the next record at or after 'offset' and moves 'offset' past it.
+bool next_text_record(const char* data, size_t size, size_t& offset, std::string_view& record) {
+    while (offset < size && is_line_separator(data[offset])) { offset++; }
+    if (offset >= size) {
+        return false;
+    }
+    size_t end = find_line_separator(data, offset, size);
+    record = std::string_view(data + offset, end - offset);
+    offset = end;
+    return true;
+}
+
+// Scans backwards from the end, so the cost does not depend on the file length.
+std::string_view find_last_text_record(const char* data, size_t size) {
+    size_t end = size;
+    while (end > 0 && is_line_separator(data[end - 1])) { end--; }
+    size_t begin = end;
+    while (begin > 0 && !is_line_separator(data[begin - 1])) { begin--; }
+    return std::string_view(data + begin, end - begin);
+}
+
+// Bytes up to and including the last separator. A final record without one is
+// a torn write, so it is neither a resume point nor something to append to.
+size_t complete_text_bytes(const char* data, size_t size) {
+    while (size > 0 && !is_line_separator(data[size - 1])) { size--; }
+    return size;
+}
+
+std::string load_last_prime(const std::string& path = SEQUENCE_FILE) {
+    MappedFile mapped;
+    if (!mapped.open(path) || mapped.size() == 0) {
+        return "";
+    }
+    return std::string(find_last_text_record(mapped.data(), complete_text_bytes(mapped.data(), mapped.size())));
+}
+
+// --- Sidecar Checkpoint ---
+// Written next to the sequence file whenever the writer flushes, so a resume
+// reads a few hundred bytes instead of the sequence. The recorded sequence size
+// ties the checkpoint to one exact state of the file.
+struct SequenceCheckpoint {
+    std::string last_prime = "";
+    long long predictions_made = 0;
+    long long mod_12 = 0;
+    long long mod_7 = 0;
+    long long sequence_bytes = 0;
+};
+
+const std::string CHECKPOINT_MAGIC = "LGO_CHECKPOINT_V1";
+
+SequenceCheckpoint resume_checkpoint; // Set by 'L' so the loop can skip the residue scan
+bool has_resume_checkpoint = false;
+
+std::string checkpoint_path_for(const std::string& sequence_path) {
+    return sequence_path + ".ckpt";
+}
 
-        if (j >= 0) {
-            sum += small_num_str[j] - '0';
-            j--;
+bool write_checkpoint(const std::string& sequence_path, const SequenceCheckpoint& checkpoint) {
+    std::string final_path = checkpoint_path_for(sequence_path);
+    std::string temp_path = final_path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << CHECKPOINT_MAGIC << "\n"
+             << "sequence_bytes " << checkpoint.sequence_bytes << "\n"
+             << "predictions_made " << checkpoint.predictions_made << "\n"
+             << "mod_12 " << checkpoint.mod_12 << "\n"
+             << "mod_7 " << checkpoint.mod_7 << "\n"
+             << "last_prime " << checkpoint.last_prime << "\n";
+        if (!file.good()) {
+            return false;
         }
+    }
+#ifdef _WIN32
+    std::remove(final_path.c_str()); // rename() does not replace on Windows
+#endif
+    return std::rename(temp_path.c_str(), final_path.c_str()) == 0;
+}
 
+// Only succeeds if the checkpoint still describes the sequence file as it is now.
+bool read_checkpoint(const std::string& sequence_path, SequenceCheckpoint& checkpoint) {
+    std::ifstream file(checkpoint_path_for(sequence_path), std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string magic, key;
+    SequenceCheckpoint loaded;
+    if (!std::getline(file, magic) || magic != CHECKPOINT_MAGIC) return false;
+    if (!(file >> key >> loaded.sequence_bytes) || key != "sequence_bytes") return false;
+    if (!(file >> key >> loaded.predictions_made) || key != "predictions_made") return false;
+    if (!(file >> key >> loaded.mod_12) || key != "mod_12") return false;
+    if (!(file >> key >> loaded.mod_7) || key != "mod_7") return false;
+    if (!(file >> key >> loaded.last_prime) || key != "last_prime") return false;
+
+    if (loaded.last_prime.empty() || loaded.last_prime.find_first_not_of("0123456789") != std::string::npos) return false;
+    if (loaded.mod_12 < 0 || loaded.mod_12 >= 12 || loaded.mod_7 < 0 || loaded.mod_7 >= 7) return false;
+    if (file_size_bytes(sequence_path) != loaded.sequence_bytes) return false;
+
+    checkpoint = loaded;
+    return true;
+}
+
+// ====================================================================
+// --- BIGINT ARITHMETIC & MODULO (Unchanged) ---
+// ====================================================================
+
+// result = large_num_str + small_num_ll (small_num_ll >= 0), written into the
+// caller's buffer so a chain that reuses it never allocates once it has grown.
+// 'result' must not alias 'large_num_str'.
+void add_strings(const std::string& large_num_str, long long small_num_ll, std::string& result) {
+    result.assign(large_num_str);
+    unsigned long long carry = (unsigned long long)small_num_ll;
+
+    for (size_t i = result.length(); i-- > 0 && carry > 0;) {
+        unsigned long long sum = (unsigned long long)(result[i] - '0') + carry;
+        result[i] = (char)('0' + sum % 10);
         carry = sum / 10;
-        sum = sum % 10;
-        
-        result.insert(0, 1, (char)(sum + '0'));
     }
 
+    if (carry > 0) {
+        char digits[20];
+        int count = 0;
+        while (carry > 0) { digits[19 - count++] = (char)('0' + carry % 10); carry /= 10; }
+        result.insert(0, digits + 20 - count, (size_t)count);
+    }
+}
+
+std::string add_strings(const std::string& large_num_str, long long small_num_ll) {
+    std::string result;
+    add_strings(large_num_str, small_num_ll, result);
     return result;
 }
 
@@ -199,352 +974,7018 @@ PrimeSet determine_prime_set(const std::string& pn_str) {
 }
 
 // ====================================================================
-// --- CORE ARITHMETIC WITH RIGID CONSTANT (C_LGO*) ---
+// --- LIMB BIGINT (BASE 10^18) ---
 // ====================================================================
+// Non-negative integer stored as little-endian base-10^18 limbs. The chain only
+// ever adds a small even gap, so '+=' stops at the first limb unless a carry runs
+// through a limb of all nines. Decimal text is only produced on demand.
 
-std::tuple<long long, std::string, long long> LGO_CalculateNextPrime_BaseGap_Detailed(const std::string& pn_str, bool& success_flag) {
-    long long digits = pn_str.length();
-    long long base_gap = (long long)std::round(((long double)digits * digits) / 50.0L) + 2; 
-    
-    long long predicted_gap = base_gap + (2 / 2); 
-    if (predicted_gap % 2 != 0) { predicted_gap += 1; }
-    if (predicted_gap < 2) { predicted_gap = 2; }
-    
-    std::string p_n_plus_1 = ""; 
-    success_flag = true; 
-    return {predicted_gap, p_n_plus_1, digits}; 
+const unsigned long long BIGINT_LIMB_BASE = 1000000000000000000ULL;
+const int BIGINT_LIMB_DIGITS = 18;
+
+const unsigned long long POW10_U64[19] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL
+};
+
+// "00" "01" ... "99": rendering two digits per division.
+const char DIGIT_PAIRS[201] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// Exactly 9 digits (leading zeros kept).
+inline void write_digits_9(char* out, unsigned int value) {
+    for (int i = 7; i > 0; i -= 2) {
+        std::memcpy(out + i, DIGIT_PAIRS + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    out[0] = (char)('0' + value);
 }
 
+// One base-10^18 limb as exactly BIGINT_LIMB_DIGITS digits, in 32-bit halves.
+inline void write_limb_digits(char* out, unsigned long long limb) {
+    write_digits_9(out, (unsigned int)(limb / 1000000000ULL));
+    write_digits_9(out + 9, (unsigned int)(limb % 1000000000ULL));
+}
 
-std::pair<long long, std::string> LGO_Predict_Deterministic(const std::string& pn_str, PredictionMetrics& metrics) {
-    bool success_flag = false;
-    
-    long long digits = pn_str.length(); 
-    metrics.current_prime_digits = digits;
-    
-    auto [base_gap_heuristic, next_p_str_temp, digits_check] = LGO_CalculateNextPrime_BaseGap_Detailed(pn_str, success_flag);
-    metrics.base_gap_out = base_gap_heuristic;
+int count_decimal_digits(unsigned long long value) {
+    int digits = 1;
+    while (digits < 19 && value >= POW10_U64[digits]) { digits++; }
+    return digits;
+}
 
-    // --- 0. RIGID CONSTANT SETUP ---
-    double g_rigid_constant = C_LGO_STAR; 
-    metrics.g_gravitational = g_rigid_constant;
+class BigInt {
+public:
+    BigInt() : limbs(1, 0) {}
 
-    // 1. DENSITY CORRECTION (G) - Uses RIGID C_LGO*
-    double ln_pn = std::log(10.0) * (digits - 1) + std::log(std::stold(pn_str.substr(0, std::min((size_t)10, pn_str.length()))));
-    
-    double phi_term = (ln_pn * std::log(g_rigid_constant)) / g_rigid_constant;
-    current_phi = phi_term; 
-    long long G_density = (long long)std::round(current_phi); 
-    metrics.density_correction_G = G_density;
+    // Expects digits only (validated by the caller, as for the string API).
+    explicit BigInt(std::string_view decimal) { assign_decimal(decimal); }
 
-    // 2. ULAM/MOD 7 DELTA (Delta)
-    current_prime_set_enum = determine_prime_set(pn_str); 
-    
-    switch (current_prime_set_enum) {
-        case SET_A: metrics.current_prime_set = "SET_A"; break;
-        case SET_B: metrics.current_prime_set = "SET_B"; break;
-        case SET_C: metrics.current_prime_set = "SET_C"; break;
-        case SET_D: metrics.current_prime_set = "SET_D"; break;
-        default: metrics.current_prime_set = "SET_UNKNOWN";
+    void assign_decimal(std::string_view decimal) {
+        limbs.clear();
+        limbs.reserve(decimal.length() / BIGINT_LIMB_DIGITS + 2);
+
+        long long end = (long long)decimal.length();
+        while (end > 0) {
+            long long begin = std::max(0LL, end - BIGINT_LIMB_DIGITS);
+            unsigned long long limb = 0;
+            for (long long i = begin; i < end; i++) {
+                limb = limb * 10 + (unsigned long long)(decimal[i] - '0');
+            }
+            limbs.push_back(limb);
+            end = begin;
+        }
+        if (limbs.empty()) { limbs.push_back(0); }
+        trim();
     }
-    
-    long long delta_12 = ulam_delta_correction_12[current_prime_set_enum];
-    
-    long long p_n_mod_7 = calculate_mod_7(pn_str); 
-    long long delta_7 = ulam_delta_correction_7[p_n_mod_7]; 
-    
-    long long delta_final = delta_12 + (long long)std::round((double)delta_7 * MATH_PI / 10.0);
-    metrics.delta_out = delta_final; 
 
-    // 3. FLUCTUATION - REMOVED (Set to zero)
-    long long fluctuation = 0; 
-    metrics.fluctuation_delta = 0;
+    // In-place addition of a small non-negative value. Returns the index of the
+    // highest limb that changed, so callers can tell how far the carry reached.
+    size_t add_small(unsigned long long value) {
+        unsigned long long carry = value / BIGINT_LIMB_BASE;
+        unsigned long long low = value % BIGINT_LIMB_BASE;
 
-    // 4. FINAL GAP CALCULATION 
-    long long final_gap = base_gap_heuristic + delta_final + G_density; 
-    
-    if (final_gap % 2 != 0) { final_gap += 1; }
-    if (final_gap < 2) { final_gap = 2; }
-    
-    metrics.final_gap = final_gap;
-    metrics.correlative_adjustment = current_phi;
-    
-    // 5. PROOF METRICS CALCULATION (PNT Ratio)
-    double ln_pn_precise = std::log(std::stold(pn_str));
-    if (ln_pn_precise > 0.0) {
-        metrics.pnt_ratio = (double)final_gap / ln_pn_precise;
-        pnt_gap_ratio = metrics.pnt_ratio; // Update global for scanner
-    } else {
-        metrics.pnt_ratio = 0.0;
+        size_t i = 0;
+        unsigned long long sum = limbs[0] + low;
+        if (sum >= BIGINT_LIMB_BASE) { sum -= BIGINT_LIMB_BASE; carry++; }
+        limbs[0] = sum;
+
+        while (carry != 0) {
+            i++;
+            if (i == limbs.size()) {
+                limbs.push_back(carry);
+                return i;
+            }
+            sum = limbs[i] + carry;
+            carry = 0;
+            if (sum >= BIGINT_LIMB_BASE) { sum -= BIGINT_LIMB_BASE; carry = 1; }
+            limbs[i] = sum;
+        }
+        return i;
     }
-    
+
+    BigInt& operator+=(unsigned long long value) {
+        add_small(value);
+        return *this;
+    }
+
+    // In-place addition of a * b (full 128-bit product). Returns the highest
+    // changed limb, like add_small().
+    size_t add_product(unsigned long long a, unsigned long long b) {
+        unsigned long long high = 0;
+        unsigned long long low = 0;
+        multiply_64x64(a, b, high, low);
+        unsigned long long limb_0 = divide_128_by_limb_base(high, low);
+        unsigned long long limb_1 = divide_128_by_limb_base(high, low);
+        unsigned long long limb_2 = low; // < 2^128 / 10^36, so one limb is enough
+
+        size_t touched = add_small_at(0, limb_0);
+        if (limb_1 != 0) { touched = std::max(touched, add_small_at(1, limb_1)); }
+        if (limb_2 != 0) { touched = std::max(touched, add_small_at(2, limb_2)); }
+        return touched;
+    }
+
+    // The value as a u64, if it fits.
+    bool to_u64(unsigned long long& value) const {
+        if (limbs.size() > 2) return false;
+        unsigned long long high = limbs.size() == 2 ? limbs[1] : 0;
+        if (high > (~0ULL - limbs[0]) / BIGINT_LIMB_BASE) return false;
+        value = high * BIGINT_LIMB_BASE + limbs[0];
+        return true;
+    }
+
+    // -1, 0 or 1 as this is less than, equal to or greater than 'other'.
+    int compare(const BigInt& other) const {
+        if (limbs.size() != other.limbs.size()) {
+            return limbs.size() < other.limbs.size() ? -1 : 1;
+        }
+        for (size_t i = limbs.size(); i-- > 0;) {
+            if (limbs[i] != other.limbs[i]) {
+                return limbs[i] < other.limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    bool is_zero() const { return limbs.size() == 1 && limbs[0] == 0; }
+
+    size_t limb_count() const { return limbs.size(); }
+
+    unsigned long long limb(size_t index) const { return limbs[index]; }
+
+    long long digit_count() const {
+        return (long long)(limbs.size() - 1) * BIGINT_LIMB_DIGITS + count_decimal_digits(limbs.back());
+    }
+
+    // Value of the leading 'count' decimal digits (1..18), or the whole value if shorter.
+    unsigned long long leading_digits(int count) const {
+        unsigned long long top = limbs.back();
+        int top_digits = count_decimal_digits(top);
+
+        if (count <= top_digits) {
+            return top / POW10_U64[top_digits - count];
+        }
+        if (limbs.size() == 1) {
+            return top;
+        }
+        int from_next = count - top_digits;
+        unsigned long long next = limbs[limbs.size() - 2];
+        return top * POW10_U64[from_next] + next / POW10_U64[BIGINT_LIMB_DIGITS - from_next];
+    }
+
+    unsigned long long mod_small(unsigned long long modulus) const {
+        unsigned long long base_mod = BIGINT_LIMB_BASE % modulus;
+        unsigned long long remainder = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            remainder = (remainder * base_mod + limbs[i] % modulus) % modulus;
+        }
+        return remainder;
+    }
+
+    // Appends the decimal representation to 'out' (no allocation if capacity allows).
+    void append_decimal(std::string& out) const {
+        char buffer[BIGINT_LIMB_DIGITS];
+        unsigned long long top = limbs.back();
+        int top_digits = count_decimal_digits(top);
+        size_t start = out.size();
+        out.resize(start + (size_t)top_digits + (limbs.size() - 1) * BIGINT_LIMB_DIGITS);
+
+        char* cursor = &out[start];
+        write_limb_digits(buffer, top);
+        std::memcpy(cursor, buffer + BIGINT_LIMB_DIGITS - top_digits, (size_t)top_digits);
+        cursor += top_digits;
+        for (size_t i = limbs.size() - 1; i-- > 0;) {
+            write_limb_digits(cursor, limbs[i]);
+            cursor += BIGINT_LIMB_DIGITS;
+        }
+    }
+
+    std::string to_string() const {
+        std::string out;
+        out.reserve((size_t)digit_count());
+        append_decimal(out);
+        return out;
+    }
+
+    // this - smaller, if this >= smaller and the difference fits in 63 bits.
+    bool difference_from(const BigInt& smaller, unsigned long long& difference) const {
+        if (smaller.limbs.size() > limbs.size()) {
+            return false;
+        }
+        unsigned long long low[2] = {0, 0};
+        unsigned long long borrow = 0;
+        for (size_t i = 0; i < limbs.size(); i++) {
+            unsigned long long subtrahend = (i < smaller.limbs.size() ? smaller.limbs[i] : 0) + borrow;
+            unsigned long long digit_limb;
+            if (limbs[i] >= subtrahend) {
+                digit_limb = limbs[i] - subtrahend;
+                borrow = 0;
+            } else {
+                digit_limb = limbs[i] + BIGINT_LIMB_BASE - subtrahend;
+                borrow = 1;
+            }
+            if (i < 2) {
+                low[i] = digit_limb;
+            } else if (digit_limb != 0) {
+                return false;
+            }
+        }
+        if (borrow != 0 || low[1] > 9) {
+            return false;
+        }
+        difference = low[1] * BIGINT_LIMB_BASE + low[0];
+        return true;
+    }
+
+    const std::vector<unsigned long long>& limb_data() const { return limbs; }
+
+    static BigInt from_limbs(std::vector<unsigned long long> little_endian_limbs) {
+        BigInt value;
+        if (!little_endian_limbs.empty()) {
+            value.limbs = std::move(little_endian_limbs);
+            value.trim();
+        }
+        return value;
+    }
+
+    bool operator==(const BigInt& other) const { return limbs == other.limbs; }
+    bool operator!=(const BigInt& other) const { return limbs != other.limbs; }
+
+private:
+    // Adds 'value' (< BIGINT_LIMB_BASE) starting at limb 'index'.
+    size_t add_small_at(size_t index, unsigned long long value) {
+        while (limbs.size() <= index) { limbs.push_back(0); }
+        size_t i = index;
+        unsigned long long sum = limbs[i] + value;
+        unsigned long long carry = 0;
+        if (sum >= BIGINT_LIMB_BASE) { sum -= BIGINT_LIMB_BASE; carry = 1; }
+        limbs[i] = sum;
+        while (carry != 0) {
+            i++;
+            if (i == limbs.size()) {
+                limbs.push_back(carry);
+                return i;
+            }
+            sum = limbs[i] + carry;
+            carry = 0;
+            if (sum >= BIGINT_LIMB_BASE) { sum -= BIGINT_LIMB_BASE; carry = 1; }
+            limbs[i] = sum;
+        }
+        trim();
+        return i;
+    }
+
+    static void multiply_64x64(unsigned long long a, unsigned long long b, unsigned long long& high, unsigned long long& low) {
+        unsigned long long a0 = a & 0xFFFFFFFFULL, a1 = a >> 32;
+        unsigned long long b0 = b & 0xFFFFFFFFULL, b1 = b >> 32;
+        unsigned long long p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        unsigned long long middle = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+        low = (middle << 32) | (p00 & 0xFFFFFFFFULL);
+        high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+    }
+
+    // (high:low) /= BIGINT_LIMB_BASE in place; returns the remainder. Bitwise
+    // long division, only used on the rare bulk-jump path.
+    static unsigned long long divide_128_by_limb_base(unsigned long long& high, unsigned long long& low) {
+        unsigned long long remainder = 0;
+        unsigned long long quotient_high = 0, quotient_low = 0;
+        for (int bit = 127; bit >= 0; bit--) {
+            unsigned long long next = (bit >= 64) ? (high >> (bit - 64)) & 1 : (low >> bit) & 1;
+            remainder = (remainder << 1) | next; // remainder < 10^18 < 2^63, no overflow
+            if (remainder >= BIGINT_LIMB_BASE) {
+                remainder -= BIGINT_LIMB_BASE;
+                if (bit >= 64) { quotient_high |= 1ULL << (bit - 64); } else { quotient_low |= 1ULL << bit; }
+            }
+        }
+        high = quotient_high;
+        low = quotient_low;
+        return remainder;
+    }
+
+    void trim() {
+        while (limbs.size() > 1 && limbs.back() == 0) { limbs.pop_back(); }
+    }
+
+    std::vector<unsigned long long> limbs;
+};
+
+// Values shorter than this are cheaper to render from scratch than to patch.
+const size_t DECIMAL_MIRROR_MIN_LIMBS = 4;
+
+// Decimal text of a chain value kept current across small additions. Adding a
+// gap below 10^18 changes limb 0 and then only the limbs a carry reaches, so
+// only those 18-digit slices of the text are re-rendered; a record costs one
+// copy of the previous text instead of a full conversion.
+class DecimalMirror {
+public:
+    // Full render; the mirror then tracks 'value'.
+    void assign(const BigInt& value) {
+        limbs.resize(value.limb_count());
+        for (size_t i = 0; i < limbs.size(); i++) { limbs[i] = value.limb(i); }
+        top_digits = count_decimal_digits(limbs.back());
+        decimal.clear();
+        value.append_decimal(decimal);
+        valid = true;
+    }
+
+    // Adds 'gap' (in (0, 10^18)) to the tracked value and re-renders the limbs
+    // the carry reached. Falls back to assign() when nothing is tracked, the
+    // length of the text changes, or the sum is not 'value' (a different chain).
+    void advance_to(const BigInt& value, unsigned long long gap) {
+        size_t count = limbs.size();
+        if (!valid || value.limb_count() != count) {
+            assign(value);
+            return;
+        }
+        unsigned long long carry = gap;
+        size_t touched = 0;
+        for (; touched < count && carry != 0; touched++) {
+            unsigned long long sum = limbs[touched] + carry;
+            carry = sum >= BIGINT_LIMB_BASE ? 1 : 0;
+            limbs[touched] = sum - carry * BIGINT_LIMB_BASE;
+        }
+        if (carry != 0 || count_decimal_digits(limbs.back()) != top_digits || !tracks(value)) {
+            assign(value);
+            return;
+        }
+        for (size_t i = 0; i < touched; i++) {
+            if (i + 1 < count) {
+                write_limb_digits(&decimal[decimal.size() - (i + 1) * BIGINT_LIMB_DIGITS], limbs[i]);
+            } else {
+                char buffer[BIGINT_LIMB_DIGITS];
+                write_limb_digits(buffer, limbs[i]);
+                std::memcpy(&decimal[0], buffer + BIGINT_LIMB_DIGITS - top_digits, (size_t)top_digits);
+            }
+        }
+    }
+
+    void invalidate() { valid = false; }
+
+    const std::string& text() const { return decimal; }
+
+private:
+    // Limb compare only: far cheaper than the render it guards.
+    bool tracks(const BigInt& value) const {
+        for (size_t i = limbs.size(); i-- > 0;) {
+            if (limbs[i] != value.limb(i)) return false;
+        }
+        return true;
+    }
+
+    std::vector<unsigned long long> limbs;
+    std::string decimal;
+    int top_digits = 0;
+    bool valid = false;
+};
+
+// Appends the text record of a chain value that lies 'gap' past the previous
+// record, patching 'mirror' instead of rendering from scratch when that pays.
+void append_text_record(std::string& out, DecimalMirror& mirror, const BigInt& candidate, long long gap) {
+    if (gap <= 0 || (unsigned long long)gap >= BIGINT_LIMB_BASE || candidate.limb_count() < DECIMAL_MIRROR_MIN_LIMBS) {
+        mirror.invalidate();
+        candidate.append_decimal(out);
+    } else {
+        mirror.advance_to(candidate, (unsigned long long)gap);
+        out.append(mirror.text());
+    }
+    out.push_back('\n');
+}
+
+long long calculate_mod_12(const BigInt& pn) {
+    return (long long)pn.mod_small(12);
+}
+
+long long calculate_mod_7(const BigInt& pn) {
+    return (long long)pn.mod_small(7);
+}
+
+PrimeSet determine_prime_set(const BigInt& pn) {
+    long long p_mod_12 = calculate_mod_12(pn);
+
+    if (p_mod_12 == 1) {
+        return SET_A;
+    } else if (p_mod_12 == 5) {
+        return SET_B;
+    } else if (p_mod_12 == 7) {
+        return SET_C; 
+    } else if (p_mod_12 == 11) {
+        return SET_D;
+    } else {
+        if (pn.limb_count() == 1 && pn.limb(0) == 2) return SET_A;
+        if (pn.limb_count() == 1 && pn.limb(0) == 3) return SET_B;
+        return SET_NONE;
+    }
+}
+
+// ====================================================================
+// --- INCREMENTAL PREDICTION STATE ---
+// ====================================================================
+// Carries everything the model reads from P_n between steps. The next value is
+// always P_n + final_gap with a small gap, so the residues are advanced from the
+// gap alone and the digit count / leading digits are only re-read from the top
+// limbs when the carry actually reaches them.
+
+const int LEADING_MANTISSA_DIGITS = 10;
+const size_t LN_ESTIMATE_LIMBS = 3; // 54 leading digits: far beyond double precision
+const long double LN_BIGINT_LIMB_BASE = std::log((long double)BIGINT_LIMB_BASE);
+
+// ln(P) without converting P: the leading limbs give the mantissa and the limb
+// count the exponent, so the cost is independent of the length of P and there
+// is no long double overflow past ~4932 digits. Shared by both model steps:
+//   step 1: ln_model()   = ln(10)*(digits-1) + ln(first 10 digits)
+//   step 5: ln_precise   = ln(top limbs) + (remaining limbs)*ln(10^18)
+// For values of up to LN_ESTIMATE_LIMBS limbs ln_precise agrees with
+// ln(stold(P)) to long double precision. It is exact only up to 19 digits:
+// above that the top limbs are rounded to a long double in a different order
+// than stold, so the two can differ in the last ulp.
+struct LnEstimate {
+    long long digits = 1;
+    unsigned long long leading_mantissa = 0; // First LEADING_MANTISSA_DIGITS digits (whole value if shorter)
+    double ln_precise = 0.0;
+
+    // 'leading' holds the top limbs of a value with 'limb_count' limbs in total.
+    static LnEstimate from_leading_limbs(const BigInt& leading, size_t limb_count) {
+        LnEstimate estimate;
+        size_t available = leading.limb_count();
+        estimate.digits = (long long)(limb_count - 1) * BIGINT_LIMB_DIGITS + count_decimal_digits(leading.limb(available - 1));
+        estimate.leading_mantissa = leading.leading_digits(LEADING_MANTISSA_DIGITS);
+
+        size_t used = std::min(available, LN_ESTIMATE_LIMBS);
+        long double mantissa = 0.0L;
+        for (size_t i = 0; i < used; i++) {
+            mantissa = mantissa * (long double)BIGINT_LIMB_BASE + (long double)leading.limb(available - 1 - i);
+        }
+        estimate.ln_precise = std::log(mantissa) + (long double)(limb_count - used) * LN_BIGINT_LIMB_BASE;
+        return estimate;
+    }
+
+    static LnEstimate of(const BigInt& value) {
+        return from_leading_limbs(value, value.limb_count());
+    }
+
+    // Parses only the digits that make up the top limbs, into 'scratch'.
+    static LnEstimate of(std::string_view decimal, BigInt& scratch) {
+        size_t length = decimal.length();
+        if (length == 0) return LnEstimate();
+        size_t top_digits = (length - 1) % BIGINT_LIMB_DIGITS + 1;
+        size_t limb_count = (length - top_digits) / BIGINT_LIMB_DIGITS + 1;
+        size_t prefix = std::min(length, top_digits + (LN_ESTIMATE_LIMBS - 1) * BIGINT_LIMB_DIGITS);
+        scratch.assign_decimal(decimal.substr(0, prefix));
+        return from_leading_limbs(scratch, limb_count);
+    }
+
+    static LnEstimate of(std::string_view decimal) {
+        BigInt scratch;
+        return of(decimal, scratch);
+    }
+
+    // Step 1 form, kept exactly as the model defines it (digit count minus one).
+    double ln_model() const {
+        return LN_10 * (digits - 1) + std::log((long double)leading_mantissa);
+    }
+};
+
+struct PredictionState {
+    BigInt prime;
+    long long mod_84 = 0; // Carries both model residues (mod 12 and mod 7)
+    LnEstimate leading; // Digit count, leading digits and ln(prime)
+
+    PredictionState() {}
+    explicit PredictionState(const BigInt& start) { reset(start); }
+    explicit PredictionState(const std::string& start) { reset(BigInt(start)); }
+
+    // Full O(n) scan, only needed when a chain is (re)started.
+    void reset(const BigInt& start) {
+        prime = start;
+        mod_84 = (long long)prime.mod_small(84);
+        refresh_leading();
+    }
+
+    // O(1) in the sequence length: residues come from a checkpoint instead of a scan.
+    void restore(const BigInt& start, long long start_mod_12, long long start_mod_7) {
+        prime = start;
+        mod_84 = (start_mod_12 * 49 + start_mod_7 * 36) % 84; // CRT: 49 = 1 (mod 12), 36 = 1 (mod 7)
+        refresh_leading();
+    }
+
+    void advance(long long gap) {
+        size_t before = prime.limb_count();
+        size_t touched = prime.add_small((unsigned long long)gap);
+
+        mod_84 = (mod_84 + gap % 84) % 84;
+
+        // The estimate only depends on the top LN_ESTIMATE_LIMBS limbs.
+        if (touched + LN_ESTIMATE_LIMBS >= before) {
+            refresh_leading();
+        }
+    }
+
+    // Adds count * step_sum in one go (used by the skip-ahead jump).
+    void advance_bulk(unsigned long long count, unsigned long long step_sum) {
+        prime.add_product(count, step_sum);
+        mod_84 = (long long)((mod_84 + (count % 84) * (step_sum % 84)) % 84);
+        refresh_leading();
+    }
+
+    long long digits() const { return leading.digits; }
+    long long mod_12() const { return mod_84 % 12; }
+    long long mod_7() const { return mod_84 % 7; }
+
+    // P = 2 and P = 3 are prime but fall outside the mod 12 sets.
+    bool is_small_special() const {
+        return leading.digits == 1 && (leading.leading_mantissa == 2 || leading.leading_mantissa == 3);
+    }
+
+private:
+    void refresh_leading() {
+        leading = LnEstimate::of(prime);
+    }
+};
+
+PrimeSet determine_prime_set(const PredictionState& state) {
+    if (state.is_small_special()) {
+        return state.leading.leading_mantissa == 2 ? SET_A : SET_B;
+    }
+    return RESIDUE_TABLE.mod_84[state.mod_84].prime_set;
+}
+
+// Set and Delta for the state in one lookup.
+ResidueModel residue_model(const PredictionState& state) {
+    if (state.is_small_special()) {
+        PrimeSet set = determine_prime_set(state);
+        return { set, ulam_delta_correction_12[set] + RESIDUE_TABLE.delta_7_rounded[state.mod_7()] };
+    }
+    return RESIDUE_TABLE.mod_84[state.mod_84];
+}
+
+// ====================================================================
+// --- BINARY SEQUENCE FORMAT ---
+// ====================================================================
+// Layout (all integers little-endian):
+//   header : "LGOSEQB1" | u32 format version | u32 keyframe interval |
+//            varint model-version length + text | keyframe of the starting prime
+//            (limb count 0 when unknown)
+//   blocks : u32 block magic | u64 first record index | u32 record count |
+//            u32 payload bytes | payload
+//   payload: keyframe of the first record, then one varint gap/2 per further record
+// A keyframe is a varint limb count followed by the base-10^18 limbs as u64.
+// Every block starts from a full value, so any record is reached by decoding at
+// most one block, and blocks can be skipped using only their headers.
+
+const char BINARY_SEQUENCE_MAGIC[8] = {'L', 'G', 'O', 'S', 'E', 'Q', 'B', '1'};
+const unsigned int BINARY_FORMAT_VERSION = 1;
+const unsigned int BINARY_BLOCK_MAGIC = 0x314B4C42; // "BLK1"
+const size_t BINARY_BLOCK_HEADER_BYTES = 20;
+const long long BINARY_DEFAULT_KEYFRAME_INTERVAL = 4096;
+const std::string LGO_MODEL_VERSION = "LGO v26";
+
+void put_u32(std::string& out, unsigned int value) {
+    for (int i = 0; i < 4; i++) { out.push_back((char)((value >> (8 * i)) & 0xFF)); }
+}
+
+void put_u64(std::string& out, unsigned long long value) {
+    for (int i = 0; i < 8; i++) { out.push_back((char)((value >> (8 * i)) & 0xFF)); }
+}
+
+void put_varint(std::string& out, unsigned long long value) {
+    while (value >= 0x80) {
+        out.push_back((char)((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+void put_keyframe(std::string& out, const BigInt& value) {
+    const std::vector<unsigned long long>& limbs = value.limb_data();
+    put_varint(out, limbs.size());
+    for (unsigned long long limb : limbs) { put_u64(out, limb); }
+}
+
+unsigned int get_u32(const unsigned char* data) {
+    unsigned int value = 0;
+    for (int i = 3; i >= 0; i--) { value = (value << 8) | data[i]; }
+    return value;
+}
+
+unsigned long long get_u64(const unsigned char* data) {
+    unsigned long long value = 0;
+    for (int i = 7; i >= 0; i--) { value = (value << 8) | data[i]; }
+    return value;
+}
+
+// Decoders advance 'cursor' and return false on truncated or malformed input.
+bool get_varint(const unsigned char*& cursor, const unsigned char* end, unsigned long long& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor >= end) return false;
+        unsigned char byte = *cursor++;
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool get_keyframe(const unsigned char*& cursor, const unsigned char* end, BigInt& value) {
+    unsigned long long limb_count = 0;
+    if (!get_varint(cursor, end, limb_count)) return false;
+    if (limb_count == 0) {
+        value = BigInt();
+        return true;
+    }
+    if ((unsigned long long)(end - cursor) / 8 < limb_count) return false;
+
+    std::vector<unsigned long long> limbs((size_t)limb_count);
+    for (size_t i = 0; i < limbs.size(); i++) {
+        limbs[i] = get_u64(cursor);
+        if (limbs[i] >= BIGINT_LIMB_BASE) return false;
+        cursor += 8;
+    }
+    value = BigInt::from_limbs(std::move(limbs));
+    return true;
+}
+
+std::string encode_binary_header(const BigInt* start_prime, long long keyframe_interval) {
+    std::string out(BINARY_SEQUENCE_MAGIC, sizeof(BINARY_SEQUENCE_MAGIC));
+    put_u32(out, BINARY_FORMAT_VERSION);
+    put_u32(out, (unsigned int)keyframe_interval);
+    put_varint(out, LGO_MODEL_VERSION.size());
+    out.append(LGO_MODEL_VERSION);
+    if (start_prime != nullptr) {
+        put_keyframe(out, *start_prime);
+    } else {
+        put_varint(out, 0);
+    }
+    return out;
+}
+
+struct BinarySequenceHeader {
+    unsigned int format_version = 0;
+    unsigned int keyframe_interval = 0;
+    std::string model_version = "";
+    bool has_start_prime = false;
+    BigInt start_prime;
+    size_t header_bytes = 0;
+};
+
+bool decode_binary_header(const unsigned char* data, size_t size, BinarySequenceHeader& header) {
+    if (size < sizeof(BINARY_SEQUENCE_MAGIC) + 8 || std::memcmp(data, BINARY_SEQUENCE_MAGIC, sizeof(BINARY_SEQUENCE_MAGIC)) != 0) {
+        return false;
+    }
+    const unsigned char* cursor = data + sizeof(BINARY_SEQUENCE_MAGIC);
+    const unsigned char* end = data + size;
+    header.format_version = get_u32(cursor);
+    header.keyframe_interval = get_u32(cursor + 4);
+    cursor += 8;
+    if (header.format_version != BINARY_FORMAT_VERSION) return false;
+
+    unsigned long long version_length = 0;
+    if (!get_varint(cursor, end, version_length) || (unsigned long long)(end - cursor) < version_length) return false;
+    header.model_version.assign((const char*)cursor, (size_t)version_length);
+    cursor += version_length;
+
+    const unsigned char* keyframe_start = cursor;
+    if (!get_keyframe(cursor, end, header.start_prime)) return false;
+    header.has_start_prime = (*keyframe_start != 0);
+    header.header_bytes = (size_t)(cursor - data);
+    return true;
+}
+
+struct BinaryBlockInfo {
+    long long first_record = 0;
+    long long record_count = 0;
+    long long payload_offset = 0;
+    long long payload_bytes = 0;
+};
+
+bool decode_block_header(const unsigned char* data, BinaryBlockInfo& block, long long header_offset) {
+    if (get_u32(data) != BINARY_BLOCK_MAGIC) return false;
+    block.first_record = (long long)get_u64(data + 4);
+    block.record_count = (long long)get_u32(data + 12);
+    block.payload_bytes = (long long)get_u32(data + 16);
+    block.payload_offset = header_offset + (long long)BINARY_BLOCK_HEADER_BYTES;
+    return block.record_count > 0;
+}
+
+// Decodes record 'index_in_block' of a block payload into 'value'.
+bool decode_block_record(const unsigned char* payload, size_t size, long long index_in_block, BigInt& value) {
+    const unsigned char* cursor = payload;
+    const unsigned char* end = payload + size;
+    if (!get_keyframe(cursor, end, value)) return false;
+
+    unsigned long long total_gap = 0;
+    for (long long i = 0; i < index_in_block; i++) {
+        unsigned long long half_gap = 0;
+        if (!get_varint(cursor, end, half_gap)) return false;
+        total_gap += half_gap * 2;
+    }
+    value.add_small(total_gap);
+    return true;
+}
+
+// Decodes every record of a block payload in order.
+template <typename RecordFn>
+bool decode_block_records(const unsigned char* payload, size_t size, long long record_count, BigInt& value, RecordFn&& on_record) {
+    const unsigned char* cursor = payload;
+    const unsigned char* end = payload + size;
+    if (!get_keyframe(cursor, end, value)) return false;
+    on_record(value);
+
+    for (long long i = 1; i < record_count; i++) {
+        unsigned long long half_gap = 0;
+        if (!get_varint(cursor, end, half_gap)) return false;
+        value.add_small(half_gap * 2);
+        on_record(value);
+    }
+    return true;
+}
+
+bool is_binary_sequence_file(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    char magic[sizeof(BINARY_SEQUENCE_MAGIC)];
+    bool binary = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) && std::memcmp(magic, BINARY_SEQUENCE_MAGIC, sizeof(magic)) == 0;
+    std::fclose(file);
+    return binary;
+}
+
+// Maps the file, decodes the header and walks the block headers once (skipping
+// payloads) to build the block index used for random access. Payloads are
+// decoded straight from the mapping.
+class BinarySequenceReader {
+public:
+    bool open(const std::string& path) {
+        close();
+        if (!mapped.open(path)) {
+            return false;
+        }
+        const unsigned char* data = (const unsigned char*)mapped.data();
+        long long size = (long long)mapped.size();
+        if (size == 0 || !decode_binary_header(data, (size_t)size, file_header)) {
+            close();
+            return false;
+        }
+
+        long long offset = (long long)file_header.header_bytes;
+        while (offset + (long long)BINARY_BLOCK_HEADER_BYTES <= size) {
+            BinaryBlockInfo block;
+            if (!decode_block_header(data + offset, block, offset)) break;
+            if (block.payload_offset + block.payload_bytes > size) break; // Torn final block
+            blocks.push_back(block);
+            offset = block.payload_offset + block.payload_bytes;
+        }
+        indexed_bytes = offset;
+        return true;
+    }
+
+    void close() {
+        mapped.close();
+        blocks.clear();
+        file_header = BinarySequenceHeader();
+        indexed_bytes = 0;
+    }
+
+    // Bytes covered by the header and complete blocks (anything after is a torn write).
+    long long valid_bytes() const { return indexed_bytes; }
+
+    const BinarySequenceHeader& header() const { return file_header; }
+
+    long long record_count() const {
+        return blocks.empty() ? 0 : blocks.back().first_record + blocks.back().record_count;
+    }
+
+    // Random access to record 'index' (0-based): decodes one block.
+    bool read_record(long long index, BigInt& value) const {
+        if (index < 0 || index >= record_count()) {
+            return false;
+        }
+        auto it = std::upper_bound(blocks.begin(), blocks.end(), index,
+            [](long long wanted, const BinaryBlockInfo& block) { return wanted < block.first_record; });
+        const BinaryBlockInfo& block = *(it - 1);
+        return decode_block_record(payload(block), (size_t)block.payload_bytes, index - block.first_record, value);
+    }
+
+    bool last_record(BigInt& value) const {
+        return read_record(record_count() - 1, value);
+    }
+
+    template <typename RecordFn>
+    bool for_each_record(RecordFn&& on_record) const {
+        mapped.advise_sequential();
+        BigInt value;
+        for (const BinaryBlockInfo& block : blocks) {
+            if (!decode_block_records(payload(block), (size_t)block.payload_bytes, block.record_count, value, on_record)) return false;
+        }
+        return true;
+    }
+
+    // Distances between consecutive values, starting from 'start' (what the
+    // first record follows). Only each block's keyframe is compared in full.
+    template <typename GapFn>
+    bool for_each_gap(const BigInt& start, GapFn&& on_gap) const {
+        BigInt previous = start;
+        BigInt keyframe;
+        for (const BinaryBlockInfo& block : blocks) {
+            const unsigned char* cursor = payload(block);
+            const unsigned char* end = cursor + block.payload_bytes;
+            unsigned long long gap = 0;
+            if (!get_keyframe(cursor, end, keyframe) || !keyframe.difference_from(previous, gap)) return false;
+            on_gap(gap);
+            for (long long i = 1; i < block.record_count; i++) {
+                unsigned long long half_gap = 0;
+                if (!get_varint(cursor, end, half_gap)) return false;
+                keyframe.add_small(half_gap * 2);
+                on_gap(half_gap * 2);
+            }
+            std::swap(previous, keyframe);
+        }
+        return true;
+    }
+
+private:
+    const unsigned char* payload(const BinaryBlockInfo& block) const {
+        return (const unsigned char*)mapped.data() + block.payload_offset;
+    }
+
+    MappedFile mapped;
+    BinarySequenceHeader file_header;
+    std::vector<BinaryBlockInfo> blocks;
+    long long indexed_bytes = 0;
+};
+
+// ====================================================================
+// --- SEQUENCE READER (TEXT OR BINARY) ---
+// ====================================================================
+// Uniform read access for analytics. Text records are returned as views into
+// the mapping (zero copy); binary records are decoded into a reusable buffer,
+// so a returned view is only valid until the next call. Random access on text
+// uses a sparse index holding the offset of every SEQUENCE_INDEX_STRIDE-th
+// record, built by a single pass the first time it is needed.
+
+const long long SEQUENCE_INDEX_STRIDE = 1024;
+
+class SequenceReader {
+public:
+    bool open(const std::string& path) {
+        close();
+        if (is_binary_sequence_file(path)) {
+            binary = true;
+            return binary_reader.open(path);
+        }
+        binary = false;
+        return mapped.open(path);
+    }
+
+    void close() {
+        mapped.close();
+        binary_reader.close();
+        sparse_offsets.clear();
+        text_records = -1;
+    }
+
+    bool is_binary() const { return binary; }
+
+    long long record_count() {
+        if (binary) {
+            return binary_reader.record_count();
+        }
+        build_index();
+        return text_records;
+    }
+
+    // Record 'index' (0-based).
+    bool record(long long index, std::string_view& out) {
+        if (binary) {
+            if (!binary_reader.read_record(index, decoded_value)) return false;
+            decoded.clear();
+            decoded_value.append_decimal(decoded);
+            out = decoded;
+            return true;
+        }
+        build_index();
+        if (index < 0 || index >= text_records) {
+            return false;
+        }
+        size_t offset = sparse_offsets[(size_t)(index / SEQUENCE_INDEX_STRIDE)];
+        for (long long skip = index % SEQUENCE_INDEX_STRIDE; skip >= 0; skip--) {
+            if (!next_text_record(mapped.data(), mapped.size(), offset, out)) return false;
+        }
+        return true;
+    }
+
+    bool last_record(std::string_view& out) {
+        if (binary) {
+            return record(binary_reader.record_count() - 1, out);
+        }
+        if (mapped.size() == 0) {
+            return false;
+        }
+        out = find_last_text_record(mapped.data(), mapped.size());
+        return !out.empty();
+    }
+
+    // Calls on_record(std::string_view) for every record in order.
+    template <typename RecordFn>
+    bool for_each_record(RecordFn&& on_record) {
+        if (binary) {
+            return binary_reader.for_each_record([&](const BigInt& value) {
+                decoded.clear();
+                value.append_decimal(decoded);
+                on_record(std::string_view(decoded));
+            });
+        }
+        mapped.advise_sequential();
+        size_t offset = 0;
+        std::string_view view;
+        while (next_text_record(mapped.data(), mapped.size(), offset, view)) {
+            on_record(view);
+        }
+        return true;
+    }
+
+private:
+    void build_index() {
+        if (text_records >= 0) {
+            return;
+        }
+        text_records = 0;
+        size_t offset = 0;
+        std::string_view view;
+        while (true) {
+            size_t record_offset = offset;
+            if (!next_text_record(mapped.data(), mapped.size(), offset, view)) break;
+            if (text_records % SEQUENCE_INDEX_STRIDE == 0) {
+                sparse_offsets.push_back(record_offset);
+            }
+            text_records++;
+        }
+    }
+
+    bool binary = false;
+    MappedFile mapped;
+    BinarySequenceReader binary_reader;
+    std::vector<size_t> sparse_offsets;
+    long long text_records = -1;
+    BigInt decoded_value;
+    std::string decoded;
+};
+
+// Resume point for a sequence file: the checkpoint when it matches the file,
+// otherwise the last record found by the tail scan (residues then come from a
+// scan of that one number, and the prediction count restarts at 0).
+bool load_resume_point(const std::string& sequence_path, SequenceCheckpoint& resume) {
+    if (read_checkpoint(sequence_path, resume)) {
+        return true;
+    }
+
+    std::string last_prime = "";
+    if (is_binary_sequence_file(sequence_path)) {
+        BinarySequenceReader reader;
+        BigInt last_value;
+        if (!reader.open(sequence_path) || !reader.last_record(last_value)) {
+            return false;
+        }
+        last_prime = last_value.to_string();
+    } else {
+        last_prime = load_last_prime(sequence_path);
+    }
+    if (last_prime.empty() || last_prime.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    resume = SequenceCheckpoint();
+    resume.last_prime = last_prime;
+    resume.mod_12 = calculate_mod_12(last_prime);
+    resume.mod_7 = calculate_mod_7(last_prime);
+    resume.sequence_bytes = file_size_bytes(sequence_path);
+    return true;
+}
+
+void restore_state(PredictionState& state, const SequenceCheckpoint& resume) {
+    state.restore(BigInt(resume.last_prime), resume.mod_12, resume.mod_7);
+}
+
+// ====================================================================
+// --- ASYNCHRONOUS FILE WRITER ---
+// ====================================================================
+// Background writer behind the sequence writer in pipelined runs. Filled
+// buffers are swapped into a small ring of slots (no copy; the caller gets back
+// an empty buffer that keeps its capacity) and a writer thread appends every
+// ready slot in one batch: io_uring on Linux (raw syscalls, no liburing),
+// overlapped WriteFile on Windows, pwrite() wherever io_uring is unavailable.
+// Checkpoints travel through the same ring, so one is only written once the
+// bytes it describes have been.
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define LGO_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+const size_t ASYNC_WRITE_SLOTS = 4; // Buffers in flight between the serializer and the writer thread
+
+// Blocking wait for the ring helpers: brief yields first, then short sleeps so
+// an idle stage does not burn a core.
+inline void pipeline_backoff(unsigned& attempts) {
+    if (++attempts < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Bounded single-producer / single-consumer ring. Slots are filled and drained
+// in place (acquire_push/commit_push, front/pop) so large elements such as
+// buffers are never copied. Each side caches the other's index and only
+// re-reads it when the ring looks full (or empty).
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) { size <<= 1; }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    // Producer: the next free slot, waiting while the ring is full.
+    T& acquire_push() {
+        unsigned attempts = 0;
+        while (tail - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (tail - cached_head > mask) { pipeline_backoff(attempts); }
+        }
+        return slots[tail & mask];
+    }
+
+    void commit_push() {
+        tail++;
+        published_tail.store(tail, std::memory_order_release);
+    }
+
+    // No further pushes; front() returns nullptr once the ring is drained.
+    void close() { closed.store(true, std::memory_order_release); }
+
+    // Consumer: the oldest filled slot, waiting while empty (nullptr when closed and drained).
+    T* front() {
+        unsigned attempts = 0;
+        while (consumer_head == cached_tail) {
+            bool was_closed = closed.load(std::memory_order_acquire); // Read before the tail: no push is missed
+            cached_tail = published_tail.load(std::memory_order_acquire);
+            if (consumer_head != cached_tail) break;
+            if (was_closed) return nullptr;
+            pipeline_backoff(attempts);
+        }
+        return &slots[consumer_head & mask];
+    }
+
+    // Consumer: filled slots available right now, without waiting.
+    size_t ready() {
+        cached_tail = published_tail.load(std::memory_order_acquire);
+        return (size_t)(cached_tail - consumer_head);
+    }
+
+    T& peek(size_t offset) { return slots[(consumer_head + offset) & mask]; }
+
+    void pop(size_t count = 1) {
+        consumer_head += count;
+        head.store(consumer_head, std::memory_order_release);
+    }
+
+    // Approximate fill level, safe from any thread.
+    size_t depth() const {
+        return (size_t)(published_tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed));
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<unsigned long long> head{ 0 };           // Written by the consumer
+    alignas(64) std::atomic<unsigned long long> published_tail{ 0 }; // Written by the producer
+    std::atomic<bool> closed{ false };
+    alignas(64) unsigned long long tail = 0;        // Producer only
+    unsigned long long cached_head = 0;             // Producer only
+    alignas(64) unsigned long long consumer_head = 0; // Consumer only
+    unsigned long long cached_tail = 0;             // Consumer only
+};
+
+#ifdef LGO_HAVE_IO_URING
+// Just enough of io_uring for batches of positioned writes.
+class IoUringWriter {
+public:
+    ~IoUringWriter() { shutdown(); }
+
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (ring_fd < 0) {
+            return false; // Old kernel, or blocked by a seccomp policy
+        }
+        sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) { sq_ring_bytes = cq_ring_bytes = std::max(sq_ring_bytes, cq_ring_bytes); }
+
+        sq_ring = mmap(nullptr, sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        cq_ring = single_mmap ? sq_ring : mmap(nullptr, cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        sqe_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqe_memory = mmap(nullptr, sqe_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sq_ring == MAP_FAILED || cq_ring == MAP_FAILED || sqe_memory == MAP_FAILED) {
+            if (sqe_memory != MAP_FAILED) munmap(sqe_memory, sqe_bytes);
+            if (sq_ring == MAP_FAILED) sq_ring = nullptr;
+            if (cq_ring == MAP_FAILED) cq_ring = nullptr;
+            shutdown();
+            return false;
+        }
+        char* sq = (char*)sq_ring;
+        char* cq = (char*)cq_ring;
+        sq_head = (unsigned*)(sq + params.sq_off.head);
+        sq_tail = (unsigned*)(sq + params.sq_off.tail);
+        sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+        sq_array = (unsigned*)(sq + params.sq_off.array);
+        cq_head = (unsigned*)(cq + params.cq_off.head);
+        cq_tail = (unsigned*)(cq + params.cq_off.tail);
+        cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+        sqes = (io_uring_sqe*)sqe_memory;
+        capacity = params.sq_entries;
+        dead = false;
+        return true;
+    }
+
+    unsigned batch_limit() const { return capacity; }
+
+    // Writes buffers[i] at offsets[i]; results[i] receives the byte count or -errno
+    // and is left alone for a write that never ran. Only returns once the kernel
+    // is done with every buffer. False when io_uring_enter failed: the ring is
+    // then dead, never entered again, and the caller finishes the rest itself.
+    bool write_batch(int fd, const std::string* const* buffers, const long long* offsets, long long* results, unsigned count) {
+        if (dead) {
+            return false;
+        }
+        const unsigned first = *sq_tail;
+        unsigned tail = first;
+        for (unsigned i = 0; i < count; i++) {
+            unsigned index = tail & sq_mask;
+            io_uring_sqe& entry = sqes[index];
+            std::memset(&entry, 0, sizeof(entry));
+            entry.opcode = IORING_OP_WRITE;
+            entry.fd = fd;
+            entry.addr = (unsigned long long)(uintptr_t)buffers[i]->data();
+            entry.len = (unsigned)buffers[i]->size();
+            entry.off = (unsigned long long)offsets[i];
+            entry.user_data = i;
+            sq_array[index] = index;
+            tail++;
+        }
+        __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+        unsigned submitted = 0, reaped = 0;
+        unsigned expected = count; // Completions to wait for
+        while (reaped < expected) {
+            unsigned to_submit = dead ? 0 : count - submitted;
+            long entered = syscall(__NR_io_uring_enter, ring_fd, to_submit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (entered < 0 && errno != EINTR) {
+                if (!dead) {
+                    // The SQ head says how many entries the kernel took. Those
+                    // are still reading their buffers and are waited for below;
+                    // the rest are taken back out of the ring.
+                    dead = true;
+                    submitted = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) - first;
+                    expected = submitted;
+                    __atomic_store_n(sq_tail, first + submitted, __ATOMIC_RELEASE);
+                } else {
+                    // Even waiting fails: poll the CQ, sleeping so the kernel can post completions.
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            } else if (entered > 0) {
+                submitted += (unsigned)entered;
+            }
+
+            unsigned head = *cq_head;
+            while (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& completion = cqes[head & cq_mask];
+                if (completion.user_data < count) { results[completion.user_data] = completion.res; }
+                head++;
+                reaped++;
+            }
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        }
+        return !dead;
+    }
+
+    void shutdown() {
+        if (sqes != nullptr) { munmap(sqes, sqe_bytes); sqes = nullptr; }
+        if (cq_ring != nullptr && cq_ring != sq_ring) { munmap(cq_ring, cq_ring_bytes); }
+        if (sq_ring != nullptr) { munmap(sq_ring, sq_ring_bytes); }
+        sq_ring = cq_ring = nullptr;
+        if (ring_fd >= 0) { ::close(ring_fd); ring_fd = -1; }
+    }
+
+private:
+    int ring_fd = -1;
+    void* sq_ring = nullptr;
+    void* cq_ring = nullptr;
+    size_t sq_ring_bytes = 0;
+    size_t cq_ring_bytes = 0;
+    size_t sqe_bytes = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    unsigned capacity = 0;
+    bool dead = false; // io_uring_enter failed; the ring is never entered again
+};
+#endif
+
+// Appends batches of buffers at the end of one file with positioned writes.
+class FileAppender {
+public:
+    ~FileAppender() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        handle = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(handle, &size)) { close(); return false; }
+        offset = (long long)size.QuadPart;
+        for (auto& event : events) { event = CreateEventA(nullptr, TRUE, FALSE, nullptr); }
+#else
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+        if (fd < 0) return false;
+        offset = (long long)lseek(fd, 0, SEEK_END);
+        if (offset < 0) { close(); return false; }
+#ifdef LGO_HAVE_IO_URING
+        use_io_uring = uring.setup((unsigned)ASYNC_WRITE_SLOTS);
+#endif
+#endif
+        return true;
+    }
+
+    long long size() const { return offset; }
+
+    const char* backend() const {
+#ifdef _WIN32
+        return "overlapped WriteFile";
+#else
+        return use_io_uring ? "io_uring" : "pwrite";
+#endif
+    }
+
+    // Writes the buffers back to back at the end of the file.
+    bool write_batch(const std::string* const* buffers, size_t count) {
+        long long offsets[ASYNC_WRITE_SLOTS];
+        long long results[ASYNC_WRITE_SLOTS];
+        long long position = offset;
+        for (size_t i = 0; i < count; i++) {
+            offsets[i] = position;
+            results[i] = -1;
+            position += (long long)buffers[i]->size();
+        }
+        bool ok = issue(buffers, offsets, results, count);
+        // Finish short or failed writes synchronously.
+        for (size_t i = 0; ok && i < count; i++) {
+            long long done = std::max(0LL, results[i]);
+            if (done < (long long)buffers[i]->size()) {
+                ok = write_at(buffers[i]->data() + done, buffers[i]->size() - (size_t)done, offsets[i] + done);
+            }
+        }
+        if (ok) { offset = position; }
+        return ok;
+    }
+
+    void close() {
+#ifdef _WIN32
+        for (auto& event : events) {
+            if (event != nullptr) { CloseHandle(event); event = nullptr; }
+        }
+        if (handle != INVALID_HANDLE_VALUE) { CloseHandle(handle); handle = INVALID_HANDLE_VALUE; }
+#else
+#ifdef LGO_HAVE_IO_URING
+        uring.shutdown();
+        use_io_uring = false;
+#endif
+        if (fd >= 0) { ::close(fd); fd = -1; }
+#endif
+    }
+
+private:
+    bool issue(const std::string* const* buffers, const long long* offsets, long long* results, size_t count) {
+#ifdef _WIN32
+        OVERLAPPED requests[ASYNC_WRITE_SLOTS];
+        bool pending[ASYNC_WRITE_SLOTS] = {};
+        for (size_t i = 0; i < count; i++) {
+            std::memset(&requests[i], 0, sizeof(OVERLAPPED));
+            requests[i].Offset = (DWORD)((unsigned long long)offsets[i] & 0xFFFFFFFFULL);
+            requests[i].OffsetHigh = (DWORD)((unsigned long long)offsets[i] >> 32);
+            requests[i].hEvent = events[i];
+            ResetEvent(events[i]);
+            BOOL started = WriteFile(handle, buffers[i]->data(), (DWORD)buffers[i]->size(), nullptr, &requests[i]);
+            pending[i] = started || GetLastError() == ERROR_IO_PENDING;
+        }
+        for (size_t i = 0; i < count; i++) {
+            DWORD written = 0;
+            if (pending[i] && GetOverlappedResult(handle, &requests[i], &written, TRUE)) {
+                results[i] = (long long)written;
+            }
+        }
+        return true;
+#else
+#ifdef LGO_HAVE_IO_URING
+        if (use_io_uring && count > 0) {
+            if (uring.write_batch(fd, buffers, offsets, results, (unsigned)count)) {
+                for (size_t i = 0; i < count; i++) {
+                    if (results[i] == -EINVAL) { use_io_uring = false; } // Kernel without IORING_OP_WRITE
+                }
+                return true;
+            }
+            // The ring has waited out the writes it started (their results are
+            // in 'results'); pwrite finishes the rest, now and for the whole run.
+            use_io_uring = false;
+        }
+#endif
+        (void)buffers; (void)offsets; (void)results; (void)count;
+        return true; // Everything else is left to write_at()
+#endif
+    }
+
+    bool write_at(const char* data, size_t length, long long position) {
+        while (length > 0) {
+#ifdef _WIN32
+            OVERLAPPED request;
+            std::memset(&request, 0, sizeof(request));
+            request.Offset = (DWORD)((unsigned long long)position & 0xFFFFFFFFULL);
+            request.OffsetHigh = (DWORD)((unsigned long long)position >> 32);
+            request.hEvent = events[0];
+            ResetEvent(events[0]);
+            DWORD chunk = (DWORD)std::min<size_t>(length, 1u << 30);
+            DWORD written = 0;
+            if (!WriteFile(handle, data, chunk, nullptr, &request) && GetLastError() != ERROR_IO_PENDING) return false;
+            if (!GetOverlappedResult(handle, &request, &written, TRUE) || written == 0) return false;
+            long long done = (long long)written;
+#else
+            long long done = (long long)::pwrite(fd, data, length, (off_t)position);
+            if (done < 0 && errno == EINTR) continue;
+            if (done <= 0) return false;
+#endif
+            data += done;
+            length -= (size_t)done;
+            position += done;
+        }
+        return true;
+    }
+
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    HANDLE events[ASYNC_WRITE_SLOTS] = {};
+#else
+    int fd = -1;
+    bool use_io_uring = false;
+#ifdef LGO_HAVE_IO_URING
+    IoUringWriter uring;
+#endif
+#endif
+    long long offset = 0;
+};
+
+struct AsyncWriteSlot {
+    std::string data;
+    bool has_checkpoint = false;
+    SequenceCheckpoint checkpoint;
+};
+
+class AsyncFileWriter {
+public:
+    AsyncFileWriter() : slots(ASYNC_WRITE_SLOTS) {}
+    ~AsyncFileWriter() { close(); }
+
+    bool open(const std::string& path) {
+        if (!appender.open(path)) {
+            return false;
+        }
+        sequence_path = path;
+        failed.store(false, std::memory_order_relaxed);
+        worker = std::thread([this]() { run(); });
+        return true;
+    }
+
+    bool is_open() const { return worker.joinable(); }
+
+    long long size() const { return appender.size(); }
+
+    // Hands 'buffer' to the writer thread; it comes back empty with the
+    // capacity of an earlier buffer. Waits while every slot is in flight.
+    void submit(std::string& buffer) {
+        AsyncWriteSlot& slot = slots.acquire_push();
+        slot.data.clear();
+        slot.data.swap(buffer);
+        slot.has_checkpoint = false;
+        queued_bytes.fetch_add((long long)slot.data.size(), std::memory_order_relaxed);
+        slots.commit_push();
+    }
+
+    // Written after every byte submitted before it.
+    void submit_checkpoint(const SequenceCheckpoint& checkpoint) {
+        AsyncWriteSlot& slot = slots.acquire_push();
+        slot.data.clear();
+        slot.has_checkpoint = true;
+        slot.checkpoint = checkpoint;
+        slots.commit_push();
+    }
+
+    // Waits until the writer thread has caught up with every submit.
+    void drain() {
+        unsigned attempts = 0;
+        while (slots.depth() > 0) { pipeline_backoff(attempts); }
+    }
+
+    bool healthy() const { return !failed.load(std::memory_order_relaxed); }
+
+    long long queued() const { return queued_bytes.load(std::memory_order_relaxed); }
+
+    double last_write_seconds() const { return last_write.load(std::memory_order_relaxed); }
+
+    const char* backend() const { return appender.backend(); }
+
+    bool close() {
+        if (!worker.joinable()) {
+            return healthy();
+        }
+        slots.close();
+        worker.join();
+        appender.close();
+        return healthy();
+    }
+
+private:
+    void run() {
+        const std::string* batch[ASYNC_WRITE_SLOTS];
+        while (slots.front() != nullptr) {
+            // Every data slot ready now, up to the next checkpoint, goes out in one batch.
+            size_t ready = std::min(slots.ready(), ASYNC_WRITE_SLOTS);
+            size_t count = 0;
+            long long bytes = 0;
+            while (count < ready && !slots.peek(count).has_checkpoint) {
+                batch[count] = &slots.peek(count).data;
+                bytes += (long long)batch[count]->size();
+                count++;
+            }
+            if (count > 0) {
+                auto started = std::chrono::steady_clock::now();
+                if (!appender.write_batch(batch, count)) {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+                last_write.store(std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count(), std::memory_order_relaxed);
+                queued_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                slots.pop(count);
+                continue;
+            }
+            // A checkpoint at the front: its data is already on disk.
+            if (healthy()) {
+                write_checkpoint(sequence_path, slots.peek(0).checkpoint);
+            }
+            slots.pop();
+        }
+    }
+
+    SpscRing<AsyncWriteSlot> slots;
+    FileAppender appender;
+    std::thread worker;
+    std::string sequence_path = "";
+    std::atomic<bool> failed{ false };
+    std::atomic<long long> queued_bytes{ 0 };
+    std::atomic<double> last_write{ 0.0 };
+};
+
+// ====================================================================
+// --- BUFFERED SEQUENCE WRITER ---
+// ====================================================================
+// One file handle for the whole run. Candidates are rendered straight into an
+// in-memory buffer and written out when the buffer fills or the flush policy
+// fires, instead of an open/seek/write/close round trip per prediction.
+
+enum SequenceFormat { SEQUENCE_TEXT, SEQUENCE_BINARY };
+
+struct SequenceWriterPolicy {
+    size_t buffer_bytes = 1 << 20;      // Flush when this much output is pending
+    long long flush_every_records = 0;  // 0 = no record-count trigger
+    long long flush_every_ms = 0;       // 0 = no time trigger
+    long long checkpoint_every_ms = 1000; // Minimum spacing of policy-driven checkpoints
+    SequenceFormat format = SEQUENCE_TEXT;
+    long long keyframe_interval = BINARY_DEFAULT_KEYFRAME_INTERVAL; // Records per binary block
+    bool async_io = false; // Full buffers go to an AsyncFileWriter thread instead of fwrite()
+};
+
+struct SequenceWriterStats {
+    long long pending_records = 0;
+    long long pending_bytes = 0;
+    long long flushes = 0;
+    double last_flush_seconds = 0.0;
+};
+
+class SequenceWriter {
+public:
+    SequenceWriter() {}
+    ~SequenceWriter() { close(); }
+
+    SequenceWriter(const SequenceWriter&) = delete;
+    SequenceWriter& operator=(const SequenceWriter&) = delete;
+
+    // 'start_prime' is recorded in the header when a new binary file is created.
+    bool open(const std::string& path, const SequenceWriterPolicy& writer_policy, const BigInt* start_prime = nullptr) {
+        close();
+        policy = writer_policy;
+        policy.keyframe_interval = std::max(1LL, std::min(policy.keyframe_interval, 0xFFFFFFFFLL));
+        next_record_index = 0;
+        last_text.invalidate();
+        write_error = false;
+
+        long long existing_bytes = std::max(0LL, file_size_bytes(path));
+        bool existing_binary = existing_bytes > 0 && is_binary_sequence_file(path);
+        if (policy.format == SEQUENCE_TEXT && existing_binary) {
+            return false; // Never append text records to a binary sequence
+        }
+        if (policy.format == SEQUENCE_TEXT && existing_bytes > 0) {
+            long long complete = -1;
+            {
+                MappedFile mapped;
+                if (mapped.open(path)) { complete = (long long)complete_text_bytes(mapped.data(), mapped.size()); }
+            }
+            if (complete < 0) return false;
+            if (complete != existing_bytes) {
+                std::error_code error;
+                std::filesystem::resize_file(path, (std::uintmax_t)complete, error); // Drop a torn final record
+                if (error) return false;
+            }
+        }
+        if (policy.format == SEQUENCE_BINARY && existing_bytes > 0) {
+            BinarySequenceReader reader;
+            if (!existing_binary || !reader.open(path)) {
+                return false;
+            }
+            next_record_index = reader.record_count();
+            long long valid = reader.valid_bytes();
+            reader.close();
+            if (valid != existing_bytes) {
+                std::error_code error;
+                std::filesystem::resize_file(path, (std::uintmax_t)valid, error); // Drop a torn final block
+                if (error) return false;
+            }
+        }
+
+        if (policy.async_io) {
+            async.reset(new AsyncFileWriter());
+            if (!async->open(path)) {
+                async.reset();
+                return false;
+            }
+            file_bytes = async->size();
+        } else {
+            file = std::fopen(path.c_str(), "ab");
+            if (file == nullptr) {
+                return false;
+            }
+            std::setvbuf(file, nullptr, _IONBF, 0); // We do our own buffering
+            seek_file_64(file, 0, SEEK_END);
+            file_bytes = tell_file_64(file);
+        }
+        file_path = path;
+        buffer.clear();
+        buffer.reserve(policy.buffer_bytes + 64);
+        block_payload.clear();
+        block_records = 0;
+        pending_records = 0;
+        last_flush = std::chrono::steady_clock::now();
+
+        if (policy.format == SEQUENCE_BINARY && file_bytes == 0) {
+            buffer.append(encode_binary_header(start_prime, policy.keyframe_interval));
+        }
+        return true;
+    }
+
+    bool is_open() const { return file != nullptr || async != nullptr; }
+
+    const std::string& path() const { return file_path; }
+
+    // Records and bytes buffered but not yet handed to the OS, and the cost of
+    // the most recent flush.
+    SequenceWriterStats stats() const {
+        SequenceWriterStats current;
+        current.pending_records = pending_records;
+        current.pending_bytes = (long long)(buffer.size() + block_payload.size());
+        current.flushes = flush_count;
+        current.last_flush_seconds = last_flush_seconds;
+        if (async != nullptr) {
+            current.pending_bytes += async->queued();
+            current.last_flush_seconds = async->last_write_seconds();
+        }
+        return current;
+    }
+
+    // While attached, every flush also records a checkpoint for 'state' (which
+    // must correspond to the last record written) and the prediction counter.
+    void attach_checkpoint(const PredictionState* state, const long long* prediction_counter) {
+        checkpoint_state = state;
+        checkpoint_counter = prediction_counter;
+    }
+
+    void detach_checkpoint() {
+        checkpoint_state = nullptr;
+        checkpoint_counter = nullptr;
+    }
+
+    // A new chain on an open writer: its first gap is relative to its seed,
+    // not to the last record, so neither the text mirror nor the open binary
+    // block may carry over.
+    void begin_chain() {
+        last_text.invalidate();
+        finish_block();
+    }
+
+    void write(const std::string& candidate) {
+        if (policy.format == SEQUENCE_BINARY) {
+            write(BigInt(candidate));
+            return;
+        }
+        last_text.invalidate();
+        buffer.append(candidate);
+        buffer.push_back('\n');
+        record_written();
+    }
+
+    void write(const BigInt& candidate) {
+        if (policy.format == SEQUENCE_BINARY) {
+            unsigned long long gap = 0;
+            bool delta_ok = block_records > 0 && candidate.difference_from(block_value, gap);
+            write_binary_record(candidate, delta_ok ? (long long)gap : 0);
+            return;
+        }
+        last_text.invalidate();
+        candidate.append_decimal(buffer);
+        buffer.push_back('\n');
+        record_written();
+    }
+
+    // Chain fast path: 'gap' is the distance from the previously written record,
+    // which lets the binary format skip the comparison against the last value
+    // and the text format patch the previous record's digits instead of
+    // converting the whole value again.
+    void write(const BigInt& candidate, long long gap) {
+        LGO_PROFILE_STAGE(PROFILE_SEQUENCE_WRITE);
+        if (policy.format == SEQUENCE_BINARY) {
+            write_binary_record(candidate, gap);
+            return;
+        }
+        append_text_record(buffer, last_text, candidate, gap);
+        record_written();
+    }
+
+    // 'records' complete text records rendered elsewhere (a shard worker).
+    // Chunks of at least a buffer go to the file directly instead of through
+    // the buffer.
+    void write_rendered(std::string_view text, long long records) {
+        if (records <= 0) {
+            return;
+        }
+        last_text.invalidate();
+        if (file != nullptr && text.size() >= policy.buffer_bytes) {
+            if (flush_buffer() && std::fwrite(text.data(), 1, text.size(), file) == text.size()) {
+                file_bytes += (long long)text.size();
+                checkpoint_if_due();
+            } else {
+                write_error = true;
+            }
+            return;
+        }
+        buffer.append(text);
+        pending_records += records - 1;
+        record_written();
+    }
+
+    // Pushes everything buffered so far to the OS and refreshes the checkpoint.
+    bool flush() {
+        bool ok = flush_buffer();
+        if (ok) {
+            save_checkpoint();
+        }
+        if (async != nullptr) {
+            async->drain();
+            ok = ok && async->healthy();
+        }
+        return ok;
+    }
+
+    // False when any write since open() failed, including the final flush.
+    bool healthy() const { return !write_error; }
+
+    // Flushes and closes the file; false when any of its writes failed.
+    bool close() {
+        if (file != nullptr) {
+            flush();
+            if (std::fclose(file) != 0) { write_error = true; }
+            file = nullptr;
+        }
+        if (async != nullptr) {
+            flush();
+            if (!async->close()) { write_error = true; }
+            async.reset();
+        }
+        detach_checkpoint();
+        return !write_error;
+    }
+
+    // Which backend an async writer uses (empty for the fwrite() path).
+    std::string io_backend() const { return async != nullptr ? async->backend() : ""; }
+
+private:
+    // Gaps that are not small, positive and even start a new block with a keyframe.
+    void write_binary_record(const BigInt& candidate, long long gap) {
+        bool encodable = block_records > 0 && gap > 0 && gap % 2 == 0;
+        if (!encodable) {
+            finish_block();
+            block_first_record = next_record_index;
+            block_value = candidate;
+            put_keyframe(block_payload, candidate);
+        } else {
+            block_value.add_small((unsigned long long)gap);
+            put_varint(block_payload, (unsigned long long)(gap / 2));
+        }
+        block_records++;
+        next_record_index++;
+        if (block_records >= policy.keyframe_interval) {
+            finish_block();
+        }
+        record_written();
+    }
+
+    void finish_block() {
+        if (block_records == 0) {
+            return;
+        }
+        put_u32(buffer, BINARY_BLOCK_MAGIC);
+        put_u64(buffer, (unsigned long long)block_first_record);
+        put_u32(buffer, (unsigned int)block_records);
+        put_u32(buffer, (unsigned int)block_payload.size());
+        buffer.append(block_payload);
+        block_payload.clear();
+        block_records = 0;
+    }
+
+    bool flush_buffer() {
+        if (!is_open()) {
+            return false;
+        }
+        finish_block(); // A flush always ends on a complete block
+        bool ok = true;
+        auto started = std::chrono::steady_clock::now();
+        if (!buffer.empty()) {
+            file_bytes += (long long)buffer.size();
+            if (async != nullptr) {
+                async->submit(buffer); // Returns an empty recycled buffer
+                buffer.reserve(policy.buffer_bytes + 64);
+                ok = async->healthy();
+            } else {
+                ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+                buffer.clear();
+            }
+        }
+        if (!ok) { write_error = true; }
+        pending_records = 0;
+        last_flush = std::chrono::steady_clock::now();
+        last_flush_seconds = std::chrono::duration<double>(last_flush - started).count();
+        flush_count++;
+        return ok;
+    }
+
+    void save_checkpoint() {
+        if (checkpoint_state == nullptr) {
+            return;
+        }
+        SequenceCheckpoint checkpoint;
+        checkpoint.last_prime = checkpoint_state->prime.to_string();
+        checkpoint.predictions_made = (checkpoint_counter != nullptr) ? *checkpoint_counter : 0;
+        checkpoint.mod_12 = checkpoint_state->mod_12();
+        checkpoint.mod_7 = checkpoint_state->mod_7();
+        checkpoint.sequence_bytes = file_bytes;
+        if (async != nullptr) {
+            async->submit_checkpoint(checkpoint); // Written once the bytes before it are
+        } else {
+            write_checkpoint(file_path, checkpoint);
+        }
+        last_checkpoint = std::chrono::steady_clock::now();
+    }
+
+    void policy_flush() {
+        if (flush_buffer()) {
+            checkpoint_if_due();
+        }
+    }
+
+    void checkpoint_if_due() {
+        if (checkpoint_state != nullptr) {
+            auto since = std::chrono::duration_cast<std::chrono::milliseconds>(last_flush - last_checkpoint).count();
+            if (since >= policy.checkpoint_every_ms) {
+                save_checkpoint();
+            }
+        }
+    }
+
+    void record_written() {
+        pending_records++;
+
+        if (buffer.size() + block_payload.size() >= policy.buffer_bytes) {
+            policy_flush();
+        } else if (policy.flush_every_records > 0 && pending_records >= policy.flush_every_records) {
+            policy_flush();
+        } else if (policy.flush_every_ms > 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - last_flush).count() >= policy.flush_every_ms) {
+                policy_flush();
+            }
+        }
+    }
+
+    std::FILE* file = nullptr;
+    std::unique_ptr<AsyncFileWriter> async;
+    std::string file_path = "";
+    SequenceWriterPolicy policy;
+    std::string buffer;
+    DecimalMirror last_text; // Previous text record, patched by the gap fast path
+    long long pending_records = 0;
+    long long file_bytes = 0;
+    bool write_error = false; // Sticky until the next open()
+    std::chrono::steady_clock::time_point last_flush;
+    std::chrono::steady_clock::time_point last_checkpoint;
+    double last_flush_seconds = 0.0;
+    long long flush_count = 0;
+    const PredictionState* checkpoint_state = nullptr;
+    const long long* checkpoint_counter = nullptr;
+
+    // Binary format: the block being assembled
+    std::string block_payload;
+    BigInt block_value;
+    long long block_records = 0;
+    long long block_first_record = 0;
+    long long next_record_index = 0;
+};
+
+// Interactive runs keep lgo_sequence.txt close to current for 'L' without a per-step open.
+SequenceWriter sequence_writer;
+
+SequenceWriterPolicy interactive_writer_policy() {
+    SequenceWriterPolicy policy;
+    policy.buffer_bytes = 64 * 1024;
+    policy.flush_every_ms = 500;
+    return policy;
+}
+
+// ====================================================================
+// --- METRICS SINK ---
+// ====================================================================
+// Streams every step's PredictionMetrics, not just the candidate. The hot path
+// only copies numbers into the columns of the current block. Full blocks are
+// handed to a background thread that formats and writes them while the
+// generator fills the other block (double buffering). Formats:
+//   csv    : header line, then one row per step
+//   ndjson : one JSON object per line
+//   bin    : "LGOMETR1" | u32 column count | per column: varint name length + name,
+//            u8 type (0 = i64, 1 = f64, 2 = u8) | blocks
+//            block: u32 "MBLK" | u32 record count | each column contiguous
+//            (little-endian, count values), in header order
+// Columns: step, digits, base_gap, G, delta, final_gap, set, phi, pnt_ratio.
+
+enum MetricsFormat { METRICS_CSV, METRICS_NDJSON, METRICS_BINARY };
+
+const char METRICS_BINARY_MAGIC[8] = {'L', 'G', 'O', 'M', 'E', 'T', 'R', '1'};
+const unsigned int METRICS_BLOCK_MAGIC = 0x4B4C424D; // "MBLK"
+const size_t METRICS_DEFAULT_BLOCK_RECORDS = 1 << 16;
+
+struct MetricsBlock {
+    std::vector<long long> step, digits, base_gap, density_g, delta, final_gap;
+    std::vector<unsigned char> prime_set;
+    std::vector<double> phi, pnt_ratio;
+
+    void reserve(size_t records) {
+        for (auto* column : {&step, &digits, &base_gap, &density_g, &delta, &final_gap}) { column->reserve(records); }
+        prime_set.reserve(records);
+        phi.reserve(records);
+        pnt_ratio.reserve(records);
+    }
+
+    void clear() {
+        for (auto* column : {&step, &digits, &base_gap, &density_g, &delta, &final_gap}) { column->clear(); }
+        prime_set.clear();
+        phi.clear();
+        pnt_ratio.clear();
+    }
+
+    size_t size() const { return step.size(); }
+};
+
+bool parse_metrics_format(const std::string& name, MetricsFormat& format) {
+    if (name == "csv") { format = METRICS_CSV; return true; }
+    if (name == "ndjson") { format = METRICS_NDJSON; return true; }
+    if (name == "bin") { format = METRICS_BINARY; return true; }
+    return false;
+}
+
+class MetricsSink {
+public:
+    ~MetricsSink() { close(); }
+
+    bool open(const std::string& path, MetricsFormat metrics_format, size_t records_per_block = METRICS_DEFAULT_BLOCK_RECORDS) {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        format = metrics_format;
+        block_records = std::max<size_t>(1, records_per_block);
+        filling.reserve(block_records);
+        writing.reserve(block_records);
+        write_failed = false;
+        write_header();
+        stopping = false;
+        pending = false;
+        worker = std::thread([this]() { writer_main(); });
+        return true;
+    }
+
+    bool is_open() const { return file != nullptr; }
+
+    void append(long long step, const PredictionMetrics& metrics) {
+        filling.step.push_back(step);
+        filling.digits.push_back(metrics.current_prime_digits);
+        filling.base_gap.push_back(metrics.base_gap_out);
+        filling.density_g.push_back(metrics.density_correction_G);
+        filling.delta.push_back(metrics.delta_out);
+        filling.final_gap.push_back(metrics.final_gap);
+        filling.prime_set.push_back((unsigned char)metrics.current_prime_set);
+        filling.phi.push_back(metrics.correlative_adjustment);
+        filling.pnt_ratio.push_back(metrics.pnt_ratio);
+        if (filling.size() >= block_records) {
+            hand_off();
+        }
+    }
+
+    // Writes everything appended so far and stops the background thread; false
+    // when any write (or the close itself) failed.
+    bool close() {
+        if (file == nullptr) {
+            return !write_failed;
+        }
+        if (filling.size() > 0) {
+            hand_off();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        worker.join();
+        if (std::fclose(file) != 0) { write_failed = true; }
+        file = nullptr;
+        return !write_failed;
+    }
+
+private:
+    // Swaps the full block with the one the writer has finished (waits only if
+    // the writer is still busy with the previous block).
+    void hand_off() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return !pending; });
+        std::swap(filling, writing);
+        filling.clear();
+        pending = true;
+        lock.unlock();
+        changed.notify_all();
+    }
+
+    void writer_main() {
+        std::string buffer;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this]() { return pending || stopping; });
+            if (!pending) {
+                return;
+            }
+            lock.unlock();
+
+            buffer.clear();
+            encode_block(writing, buffer);
+            bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+
+            lock.lock();
+            if (!written) { write_failed = true; }
+            pending = false;
+            lock.unlock();
+            changed.notify_all();
+        }
+    }
+
+    void write_header() {
+        std::string header;
+        if (format == METRICS_CSV) {
+            header = "step,digits,base_gap,G,delta,final_gap,set,phi,pnt_ratio\n";
+        } else if (format == METRICS_BINARY) {
+            header.append(METRICS_BINARY_MAGIC, sizeof(METRICS_BINARY_MAGIC));
+            const std::pair<const char*, unsigned char> columns[] = {
+                {"step", 0}, {"digits", 0}, {"base_gap", 0}, {"G", 0}, {"delta", 0}, {"final_gap", 0},
+                {"set", 2}, {"phi", 1}, {"pnt_ratio", 1}};
+            put_u32(header, (unsigned int)(sizeof(columns) / sizeof(columns[0])));
+            for (const auto& column : columns) {
+                put_varint(header, std::strlen(column.first));
+                header.append(column.first);
+                header.push_back((char)column.second);
+            }
+        }
+        if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+            write_failed = true;
+        }
+    }
+
+    static void put_double(std::string& out, double value) {
+        unsigned long long bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        put_u64(out, bits);
+    }
+
+    static void append_number(std::string& out, long long value) {
+        char text[24];
+        char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+        out.append(text, (size_t)(end - text));
+    }
+
+    // Shortest text that reads back as the same double, so the text formats
+    // carry exactly what the binary one does.
+    static void append_number(std::string& out, double value) {
+        char text[32];
+        char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+        out.append(text, (size_t)(end - text));
+    }
+
+    void encode_block(const MetricsBlock& block, std::string& out) const {
+        size_t count = block.size();
+        if (format == METRICS_BINARY) {
+            put_u32(out, METRICS_BLOCK_MAGIC);
+            put_u32(out, (unsigned int)count);
+            for (const auto* column : {&block.step, &block.digits, &block.base_gap, &block.density_g, &block.delta, &block.final_gap}) {
+                for (long long value : *column) { put_u64(out, (unsigned long long)value); }
+            }
+            out.append(reinterpret_cast<const char*>(block.prime_set.data()), count);
+            for (double value : block.phi) { put_double(out, value); }
+            for (double value : block.pnt_ratio) { put_double(out, value); }
+            return;
+        }
+
+        // Rows are appended field by field, without temporaries.
+        static const char* const NDJSON_INTEGER_KEYS[6] = {
+            "{\"step\":", ",\"digits\":", ",\"base_gap\":", ",\"G\":", ",\"delta\":", ",\"final_gap\":"};
+        bool csv = format == METRICS_CSV;
+        for (size_t i = 0; i < count; i++) {
+            const long long integers[6] = {block.step[i], block.digits[i], block.base_gap[i], block.density_g[i], block.delta[i], block.final_gap[i]};
+            for (int column = 0; column < 6; column++) {
+                if (csv) {
+                    if (column > 0) { out += ','; }
+                } else {
+                    out += NDJSON_INTEGER_KEYS[column];
+                }
+                append_number(out, integers[column]);
+            }
+            out += csv ? "," : ",\"set\":\"";
+            out += prime_set_name((PrimeSet)block.prime_set[i]);
+            out += csv ? "," : "\",\"phi\":";
+            append_number(out, block.phi[i]);
+            out += csv ? "," : ",\"pnt_ratio\":";
+            append_number(out, block.pnt_ratio[i]);
+            out += csv ? "\n" : "}\n";
+        }
+    }
+
+    std::FILE* file = nullptr;
+    MetricsFormat format = METRICS_CSV;
+    size_t block_records = METRICS_DEFAULT_BLOCK_RECORDS;
+    MetricsBlock filling;
+    MetricsBlock writing;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool pending = false;
+    bool stopping = false;
+    bool write_failed = false; // Guarded by 'mutex' while the writer thread runs
+};
+
+
+// ====================================================================
+// --- SEQUENCE FORMAT CONVERSION ---
+// ====================================================================
+
+bool convert_text_to_binary(const std::string& text_path, const std::string& binary_path, long long keyframe_interval) {
+    SequenceReader reader;
+    if (!reader.open(text_path) || reader.is_binary()) {
+        std::cerr << "Could not open text input: " << text_path << std::endl;
+        return false;
+    }
+    if (file_size_bytes(binary_path) > 0) {
+        std::cerr << "Refusing to overwrite existing output: " << binary_path << std::endl;
+        return false;
+    }
+
+    SequenceWriterPolicy policy;
+    policy.format = SEQUENCE_BINARY;
+    policy.keyframe_interval = keyframe_interval;
+    SequenceWriter writer;
+    if (!writer.open(binary_path, policy)) {
+        std::cerr << "Could not open output: " << binary_path << std::endl;
+        return false;
+    }
+
+    long long records = 0;
+    bool valid = true;
+    BigInt value;
+    reader.for_each_record([&](std::string_view record) {
+        if (!valid) return;
+        if (record.find_first_not_of("0123456789") != std::string_view::npos) {
+            std::cerr << "Invalid record after " << records << " records: " << record.substr(0, 40) << std::endl;
+            valid = false;
+            return;
+        }
+        value.assign_decimal(record);
+        writer.write(value);
+        records++;
+    });
+    if (!writer.close()) {
+        std::cerr << "Could not write output: " << binary_path << std::endl;
+        valid = false;
+    }
+    if (valid) {
+        std::cout << "Converted " << records << " records to " << binary_path << std::endl;
+    }
+    return valid;
+}
+
+bool convert_binary_to_text(const std::string& binary_path, const std::string& text_path) {
+    BinarySequenceReader reader;
+    if (!reader.open(binary_path)) {
+        std::cerr << "Not a readable binary sequence: " << binary_path << std::endl;
+        return false;
+    }
+    if (file_size_bytes(text_path) > 0) {
+        std::cerr << "Refusing to overwrite existing output: " << text_path << std::endl;
+        return false;
+    }
+
+    SequenceWriter writer;
+    if (!writer.open(text_path, SequenceWriterPolicy())) {
+        std::cerr << "Could not open output: " << text_path << std::endl;
+        return false;
+    }
+    bool ok = reader.for_each_record([&](const BigInt& value) { writer.write(value); });
+    if (!writer.close()) {
+        std::cerr << "Could not write output: " << text_path << std::endl;
+        return false;
+    }
+    std::cout << "Converted " << reader.record_count() << " records to " << text_path << std::endl;
+    return ok;
+}
+
+// Prints candidate #step (1-based, as counted by predictions_made) of a text or binary sequence.
+int print_sequence_record(const std::string& path, long long step) {
+    SequenceReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Could not open sequence: " << path << std::endl;
+        return 1;
+    }
+    std::string_view record;
+    if (!reader.record(step - 1, record)) {
+        std::cerr << "Step " << step << " is outside 1.." << reader.record_count() << std::endl;
+        return 1;
+    }
+    std::cout << record << std::endl;
+    return 0;
+}
+
+// Post-hoc analytics over a text or binary sequence: set (A/B/C/D) frequencies,
+// gaps between consecutive records and the PNT ratio (gap / ln(P_n)) distribution.
+int print_sequence_stats(const std::string& path) {
+    SequenceReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Could not open sequence: " << path << std::endl;
+        return 1;
+    }
+
+    const int RATIO_BUCKETS = 40; // Width 0.25 over [0, 10), last bucket open-ended
+    long long set_counts[5] = {0, 0, 0, 0, 0};
+    long long ratio_histogram[RATIO_BUCKETS] = {0};
+    long long records = 0, gaps = 0, chain_breaks = 0;
+    long long min_digits = 0, max_digits = 0;
+    unsigned long long min_gap = 0, max_gap = 0;
+    long double gap_sum = 0.0L, ratio_sum = 0.0L;
+
+    BigInt value, previous;
+    bool valid = true;
+    reader.for_each_record([&](std::string_view record) {
+        if (!valid) return;
+        if (record.find_first_not_of("0123456789") != std::string_view::npos) {
+            valid = false;
+            return;
+        }
+        value.assign_decimal(record);
+        long long digits = value.digit_count();
+        min_digits = (records == 0) ? digits : std::min(min_digits, digits);
+        max_digits = std::max(max_digits, digits);
+        set_counts[determine_prime_set(value)]++;
+
+        unsigned long long gap = 0;
+        if (records > 0) {
+            if (value.difference_from(previous, gap) && gap > 0) {
+                long long previous_digits = previous.digit_count();
+                int lead = (int)std::min(18LL, previous_digits);
+                double ln_previous = std::log((double)previous.leading_digits(lead)) + LN_10 * (double)(previous_digits - lead);
+                double ratio = (ln_previous > 0.0) ? (double)gap / ln_previous : 0.0;
+
+                min_gap = (gaps == 0) ? gap : std::min(min_gap, gap);
+                max_gap = std::max(max_gap, gap);
+                gap_sum += gap;
+                ratio_sum += ratio;
+                ratio_histogram[std::min(RATIO_BUCKETS - 1, std::max(0, (int)(ratio * 4.0)))]++;
+                gaps++;
+            } else {
+                chain_breaks++; // Another chain was appended to the same file
+            }
+        }
+        previous = value;
+        records++;
+    });
+
+    if (!valid) {
+        std::cerr << "Invalid record after " << records << " records." << std::endl;
+        return 1;
+    }
+
+    std::cout << "--- Sequence Statistics: " << path << (reader.is_binary() ? " (binary)" : " (text)") << " ---" << std::endl;
+    std::cout << "Records: " << records << "   Chain breaks: " << chain_breaks << std::endl;
+    std::cout << "Digits: " << min_digits << " .. " << max_digits << std::endl;
+
+    for (int i = 1; i <= 4; i++) {
+        double share = (records > 0) ? 100.0 * (double)set_counts[i] / (double)records : 0.0;
+        std::cout << prime_set_name((PrimeSet)i) << ": " << set_counts[i] << " (" << std::fixed << std::setprecision(2) << share << "%)" << std::endl;
+    }
+    if (set_counts[0] > 0) {
+        std::cout << prime_set_name(SET_NONE) << ": " << set_counts[0] << std::endl;
+    }
+
+    if (gaps > 0) {
+        std::cout << "Gap: min " << min_gap << "  mean " << std::fixed << std::setprecision(3) << (double)(gap_sum / gaps) << "  max " << max_gap << std::endl;
+        std::cout << "PNT Ratio mean: " << std::fixed << std::setprecision(6) << (double)(ratio_sum / gaps) << std::endl;
+        std::cout << "PNT Ratio histogram:" << std::endl;
+        for (int b = 0; b < RATIO_BUCKETS; b++) {
+            if (ratio_histogram[b] == 0) continue;
+            std::cout << "  [" << std::fixed << std::setprecision(2) << b / 4.0 << ", ";
+            if (b == RATIO_BUCKETS - 1) { std::cout << "inf)"; } else { std::cout << (b + 1) / 4.0 << ")"; }
+            std::cout << "  " << ratio_histogram[b] << std::endl;
+        }
+    }
+    return 0;
+}
+
+
+// ====================================================================
+// --- CORE ARITHMETIC WITH RIGID CONSTANT (C_LGO*) ---
+// ====================================================================
+
+std::tuple<long long, std::string, long long> LGO_CalculateNextPrime_BaseGap_Detailed(const std::string& pn_str, bool& success_flag) {
+    long long digits = pn_str.length();
+    long long base_gap = (long long)std::round(((long double)digits * digits) / 50.0L) + 2; 
+    
+    long long predicted_gap = base_gap + (2 / 2); 
+    if (predicted_gap % 2 != 0) { predicted_gap += 1; }
+    if (predicted_gap < 2) { predicted_gap = 2; }
+    
+    std::string p_n_plus_1 = ""; 
+    success_flag = true; 
+    return {predicted_gap, p_n_plus_1, digits}; 
+}
+
+long long LGO_BaseGap_ForDigits(long long digits) {
+    long long base_gap = (long long)std::round(((long double)digits * digits) / 50.0L) + 2; 
+    
+    long long predicted_gap = base_gap + (2 / 2); 
+    if (predicted_gap % 2 != 0) { predicted_gap += 1; }
+    if (predicted_gap < 2) { predicted_gap = 2; }
+    return predicted_gap;
+}
+
+std::tuple<long long, BigInt, long long> LGO_CalculateNextPrime_BaseGap_Detailed(const BigInt& pn, bool& success_flag) {
+    long long digits = pn.digit_count();
+    success_flag = true; 
+    return {LGO_BaseGap_ForDigits(digits), BigInt(), digits}; 
+}
+
+
+// --- DENSITY ROUNDING ---
+// G = round(phi_term) is the only step whose result depends on the last bits of
+// a transcendental evaluation: std::log differs between libms (and long double
+// is plain double on MSVC), so a phi_term just off a .5 boundary could round
+// either way depending on the platform. The double path is accurate to far
+// better than DENSITY_ERROR_BOUND (relative), so outside that band its rounding
+// is the rounding of the exact value and is kept as is. Inside the band (a
+// chain step lands there with probability ~2^-39 * phi_term, below 10^-7 even
+// at a million digits; the jump's segment search probes it on purpose),
+// phi_term is re-evaluated in double-double arithmetic (~106 bits) built only
+// from correctly rounded IEEE operations, so every platform decides alike.
+const double DENSITY_ERROR_BOUND = 0x1p-40;
+
+std::atomic<unsigned long long> density_fallbacks{ 0 }; // Decisions taken by the double-double tier
+
+struct DoubleDouble {
+    double hi = 0.0;
+    double lo = 0.0;
+};
+
+const DoubleDouble LN_2_DD = { 0x1.62e42fefa39efp-1, 0x1.abc9e3b39803fp-56 };
+const DoubleDouble LN_10_DD = { 0x1.26bb1bbb55516p+1, -0x1.f48ad494ea3e9p-53 };
+
+inline DoubleDouble dd_two_sum(double a, double b) {
+    double sum = a + b;
+    double b_virtual = sum - a;
+    return { sum, (a - (sum - b_virtual)) + (b - b_virtual) };
+}
+
+inline DoubleDouble dd_quick_two_sum(double a, double b) {
+    double sum = a + b;
+    return { sum, b - (sum - a) };
+}
+
+inline DoubleDouble dd_add(const DoubleDouble& a, const DoubleDouble& b) {
+    DoubleDouble high = dd_two_sum(a.hi, b.hi);
+    DoubleDouble low = dd_two_sum(a.lo, b.lo);
+    high = dd_quick_two_sum(high.hi, high.lo + low.hi);
+    return dd_quick_two_sum(high.hi, high.lo + low.lo);
+}
+
+inline DoubleDouble dd_mul(const DoubleDouble& a, const DoubleDouble& b) {
+    double product = a.hi * b.hi;
+    double error = std::fma(a.hi, b.hi, -product);
+    return dd_quick_two_sum(product, error + (a.hi * b.lo + a.lo * b.hi));
+}
+
+inline DoubleDouble dd_mul(const DoubleDouble& a, double b) {
+    return dd_mul(a, DoubleDouble{ b, 0.0 });
+}
+
+inline DoubleDouble dd_div(const DoubleDouble& a, const DoubleDouble& b) {
+    double first = a.hi / b.hi;
+    DoubleDouble rest = dd_add(a, dd_mul(b, -first));
+    double second = rest.hi / b.hi;
+    rest = dd_add(rest, dd_mul(b, -second));
+    double third = rest.hi / b.hi;
+    return dd_add(dd_quick_two_sum(first, second), DoubleDouble{ third, 0.0 });
+}
+
+// ln(m) for 1 <= m < 2^53: m = r * 2^e with r in [sqrt(1/2), sqrt(2)), then
+// ln(r) = 2 atanh(s), s = (r-1)/(r+1); |s| <= 0.1716, so 24 terms are exact
+// to well below the double-double precision.
+DoubleDouble dd_ln_integer(unsigned long long m) {
+    int exponent = 0;
+    double r = std::frexp((double)m, &exponent);
+    if (r < 0x1.6a09e667f3bcdp-1) { r *= 2.0; exponent--; }
+    DoubleDouble s = dd_div(DoubleDouble{ r - 1.0, 0.0 }, dd_two_sum(r, 1.0));
+    DoubleDouble s_squared = dd_mul(s, s);
+    DoubleDouble power = s;
+    DoubleDouble series = s;
+    for (int k = 1; k < 24; k++) {
+        power = dd_mul(power, s_squared);
+        series = dd_add(series, dd_div(power, DoubleDouble{ (double)(2 * k + 1), 0.0 }));
+    }
+    return dd_add(dd_mul(LN_2_DD, (double)exponent), dd_mul(series, 2.0));
+}
+
+// round(phi_term), where phi_term = ln_model * ln_c / c was evaluated in double
+// for a value with 'digits' digits and leading digits 'leading_mantissa'.
+long long LGO_RoundDensity(double phi_term, long long digits, unsigned long long leading_mantissa, double ln_c, double c) {
+    double floor_term = std::floor(phi_term);
+    double bound = DENSITY_ERROR_BOUND * std::max(1.0, std::fabs(phi_term));
+    if (!(phi_term >= 0.0) || leading_mantissa == 0 || std::fabs(phi_term - floor_term - 0.5) > bound) {
+        return (long long)std::round(phi_term);
+    }
+    density_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    DoubleDouble ln_model = dd_add(dd_mul(LN_10_DD, (double)(digits - 1)), dd_ln_integer(leading_mantissa));
+    DoubleDouble exact = dd_div(dd_mul(ln_model, ln_c), DoubleDouble{ c, 0.0 });
+    DoubleDouble offset = dd_add(exact, DoubleDouble{ -(floor_term + 0.5), 0.0 });
+    return (long long)floor_term + (offset.hi >= 0.0 ? 1 : 0); // Halves round away from zero, as std::round
+}
+
+// Step 1 density term (before rounding to G).
+double LGO_DensityTerm(const LnEstimate& leading) {
+    double ln_pn = leading.ln_model();
+    return (ln_pn * LN_C_LGO_STAR) / C_LGO_STAR;
+}
+
+// Step 4: the sum of the components, forced even and at least 2.
+long long LGO_FinalGap(long long base_gap, long long delta, long long G_density) {
+    long long final_gap = base_gap + delta + G_density; 
+    
+    if (final_gap % 2 != 0) { final_gap += 1; }
+    if (final_gap < 2) { final_gap = 2; }
+    return final_gap;
+}
+
+// Per-chain buffers for the string reference path. A chain that keeps one
+// across steps (swapping 'next' back in as its current value) allocates nothing
+// once the buffers have reached the length of its primes.
+struct StepScratch {
+    BigInt leading;       // Top limbs parsed for ln(P)
+    std::string next = ""; // P_n + final_gap
+};
+
+long long LGO_Predict_Deterministic(const std::string& pn_str, PredictionMetrics& metrics, StepScratch& scratch) {
+    bool success_flag = false;
+    
+    long long digits = pn_str.length(); 
+    metrics.current_prime_digits = digits;
+    
+    auto [base_gap_heuristic, next_p_str_temp, digits_check] = LGO_CalculateNextPrime_BaseGap_Detailed(pn_str, success_flag);
+    metrics.base_gap_out = base_gap_heuristic;
+
+    // --- 0. RIGID CONSTANT SETUP ---
+    double g_rigid_constant = C_LGO_STAR; 
+    metrics.g_gravitational = g_rigid_constant;
+
+    // 1. DENSITY CORRECTION (G) - Uses RIGID C_LGO*
+    LnEstimate ln_estimate = LnEstimate::of(pn_str, scratch.leading);
+    double ln_pn = ln_estimate.ln_model();
+    
+    double phi_term = (ln_pn * LN_C_LGO_STAR) / g_rigid_constant;
+    long long G_density = LGO_RoundDensity(phi_term, ln_estimate.digits, ln_estimate.leading_mantissa, LN_C_LGO_STAR, g_rigid_constant); 
+    metrics.density_correction_G = G_density;
+
+    // 2. ULAM/MOD 7 DELTA (Delta)
+    PrimeSet prime_set = determine_prime_set(pn_str); 
+    metrics.current_prime_set = prime_set;
+    
+    long long delta_12 = ulam_delta_correction_12[prime_set];
+    
+    long long p_n_mod_7 = calculate_mod_7(pn_str); 
+    long long delta_7 = ulam_delta_correction_7[p_n_mod_7]; 
+    
+    long long delta_final = delta_12 + (long long)std::round((double)delta_7 * MATH_PI / 10.0);
+    metrics.delta_out = delta_final; 
+
+    // 3. FLUCTUATION - REMOVED (Set to zero)
+    metrics.fluctuation_delta = 0;
+
+    // 4. FINAL GAP CALCULATION 
+    long long final_gap = base_gap_heuristic + delta_final + G_density; 
+    
+    if (final_gap % 2 != 0) { final_gap += 1; }
+    if (final_gap < 2) { final_gap = 2; }
+    
+    metrics.final_gap = final_gap;
+    metrics.correlative_adjustment = phi_term;
+    
+    // 5. PROOF METRICS CALCULATION (PNT Ratio)
+    double ln_pn_precise = ln_estimate.ln_precise;
+    if (ln_pn_precise > 0.0) {
+        metrics.pnt_ratio = (double)final_gap / ln_pn_precise;
+    } else {
+        metrics.pnt_ratio = 0.0;
+    }
+    
+    metrics.zeta_correlation_Z = 0; 
+    metrics.rh_condition_status = RH_STATUS_STABLE;
+    
+    // 6. BIGINT Addition
+    add_strings(pn_str, final_gap, scratch.next);
+    
+    return final_gap;
+}
+
+std::pair<long long, std::string> LGO_Predict_Deterministic(const std::string& pn_str, PredictionMetrics& metrics) {
+    StepScratch scratch;
+    long long final_gap = LGO_Predict_Deterministic(pn_str, metrics, scratch);
+    return {final_gap, std::move(scratch.next)};
+}
+
+// Pure, reentrant form of the model: reads only 'state' and returns the metrics
+// for P_n (final_gap included). No allocation; the only writes outside the
+// result are the calling thread's own stage counters.
+PredictionMetrics LGO_ComputeMetrics(const PredictionState& state) {
+    PredictionMetrics metrics;
+    long long digits = state.leading.digits; 
+    metrics.current_prime_digits = digits;
+    
+    long long base_gap_heuristic = LGO_BaseGap_ForDigits(digits);
+    metrics.base_gap_out = base_gap_heuristic;
+
+    // --- 0. RIGID CONSTANT SETUP ---
+    const double g_rigid_constant = C_LGO_STAR; 
+    metrics.g_gravitational = g_rigid_constant;
+
+    // 1. DENSITY CORRECTION (G) - Uses RIGID C_LGO*
+    double phi_term = 0.0;
+    long long G_density = 0;
+    {
+        LGO_PROFILE_STAGE(PROFILE_DENSITY_G);
+        phi_term = LGO_DensityTerm(state.leading);
+        G_density = LGO_RoundDensity(phi_term, state.leading.digits, state.leading.leading_mantissa, LN_C_LGO_STAR, C_LGO_STAR); 
+    }
+    metrics.density_correction_G = G_density;
+
+    // 2. ULAM/MOD 7 DELTA (Delta) - one lookup in the mod 84 table
+    ResidueModel residue{};
+    {
+        LGO_PROFILE_STAGE(PROFILE_DELTA);
+        residue = residue_model(state);
+    }
+    metrics.current_prime_set = residue.prime_set;
+    
+    long long delta_final = residue.delta;
+    metrics.delta_out = delta_final; 
+
+    // 3. FLUCTUATION - REMOVED (Set to zero)
+    metrics.fluctuation_delta = 0;
+
+    // 4. FINAL GAP CALCULATION 
+    long long final_gap = 0;
+    {
+        LGO_PROFILE_STAGE(PROFILE_FINAL_GAP);
+        final_gap = LGO_FinalGap(base_gap_heuristic, delta_final, G_density);
+    }
+    
+    metrics.final_gap = final_gap;
+    metrics.correlative_adjustment = phi_term;
+    
+    // 5. PROOF METRICS CALCULATION (PNT Ratio)
+    {
+        LGO_PROFILE_STAGE(PROFILE_PNT_RATIO);
+        double ln_pn_precise = state.leading.ln_precise;
+        if (ln_pn_precise > 0.0) {
+            metrics.pnt_ratio = (double)final_gap / ln_pn_precise;
+        } else {
+            metrics.pnt_ratio = 0.0;
+        }
+    }
+    
     metrics.zeta_correlation_Z = 0; 
-    metrics.rh_condition_status = "STABLE (C_LGO*)";
+    metrics.rh_condition_status = RH_STATUS_STABLE;
+    return metrics;
+}
+
+struct PredictionStep {
+    PredictionState next;
+    PredictionMetrics metrics;
+};
+
+// Value-semantics API: input state in, successor state and metrics out.
+PredictionStep LGO_Predict(const PredictionState& state) {
+    PredictionStep step;
+    step.metrics = LGO_ComputeMetrics(state);
+    step.next = state;
+    step.next.advance(step.metrics.final_gap);
+    return step;
+}
+
+// In-place form used by the chain loops (no state copy): computes the metrics
+// for P_n, then advances the state to P_n + final_gap. Returns final_gap.
+long long LGO_Predict_Deterministic(PredictionState& state, PredictionMetrics& metrics) {
+    metrics = LGO_ComputeMetrics(state);
+    
+    // 6. BIGINT Addition (in place) + O(1) residue update
+    {
+        LGO_PROFILE_STAGE(PROFILE_BIGINT_ADD);
+        state.advance(metrics.final_gap);
+    }
+    
+    return metrics.final_gap;
+}
+
+std::pair<long long, BigInt> LGO_Predict_Deterministic(const BigInt& pn, PredictionMetrics& metrics) {
+    PredictionState state(pn);
+    long long final_gap = LGO_Predict_Deterministic(state, metrics);
+    return {final_gap, state.prime};
+}
+
+
+// ====================================================================
+// --- RUNTIME MODEL DESCRIPTION ---
+// ====================================================================
+// The model constants as data, so variants can be evaluated without a
+// rebuild. LGO_Model::standard() gives exactly the gaps of LGO_ComputeMetrics():
+// the derived constants stay the compiled ones unless phi_dampener changes.
+
+struct LGO_Model {
+    double phi_dampener = PHI_DAMPENER;
+    long double base_gap_divisor = 50.0L;
+    long long delta_12[ULAM_CORRECTION_SIZE] = {};
+    long long delta_7[MOD_7_CORRECTION_SIZE] = {};
+
+    // Filled in by prepare().
+    double c_lgo_star = C_LGO_STAR;
+    double ln_c_lgo_star = LN_C_LGO_STAR;
+    long long delta_84[84] = {};
+    long long delta_special[2] = {}; // P = 2 and P = 3
+
+    static LGO_Model standard() {
+        LGO_Model model;
+        std::copy(ulam_delta_correction_12, ulam_delta_correction_12 + ULAM_CORRECTION_SIZE, model.delta_12);
+        std::copy(ulam_delta_correction_7, ulam_delta_correction_7 + MOD_7_CORRECTION_SIZE, model.delta_7);
+        model.prepare();
+        return model;
+    }
+
+    // Re-derives C_LGO* and the residue table after the parameters changed.
+    void prepare() {
+        if (phi_dampener == PHI_DAMPENER) {
+            c_lgo_star = C_LGO_STAR;
+            ln_c_lgo_star = LN_C_LGO_STAR;
+        } else {
+            c_lgo_star = C_LGO_STATIC * phi_dampener * (std::log(C_LGO_STATIC) / std::log(MATH_E * MATH_PI));
+            ln_c_lgo_star = std::log(c_lgo_star);
+        }
+        for (int r = 0; r < 84; r++) {
+            delta_84[r] = delta_12[prime_set_for_mod_12(r % 12)] + rounded_delta_7(r % 7);
+        }
+        delta_special[0] = delta_12[SET_A] + rounded_delta_7(2);
+        delta_special[1] = delta_12[SET_B] + rounded_delta_7(3);
+    }
+
+    long long base_gap(long long digits) const {
+        long long base = (long long)std::round(((long double)digits * digits) / base_gap_divisor) + 2;
+        long long predicted_gap = base + (2 / 2);
+        if (predicted_gap % 2 != 0) { predicted_gap += 1; }
+        if (predicted_gap < 2) { predicted_gap = 2; }
+        return predicted_gap;
+    }
+
+    long long density(double ln_model, long long digits, unsigned long long leading_mantissa) const {
+        return LGO_RoundDensity((ln_model * ln_c_lgo_star) / c_lgo_star, digits, leading_mantissa, ln_c_lgo_star, c_lgo_star);
+    }
+
+    // 'special' is 0, or 1 / 2 for P = 2 / P = 3 (outside the mod 12 sets).
+    long long final_gap(long long digits, double ln_model, unsigned long long leading_mantissa, int mod_84, int special) const {
+        long long delta = special != 0 ? delta_special[special - 1] : delta_84[mod_84];
+        return LGO_FinalGap(base_gap(digits), delta, density(ln_model, digits, leading_mantissa));
+    }
+
+    long long final_gap(const PredictionState& state) const {
+        int special = state.is_small_special() ? (state.leading.leading_mantissa == 2 ? 1 : 2) : 0;
+        return final_gap(state.leading.digits, state.leading.ln_model(), state.leading.leading_mantissa, (int)state.mod_84, special);
+    }
+
+private:
+    long long rounded_delta_7(int residue) const {
+        return round_half_away((double)delta_7[residue] * MATH_PI / 10.0);
+    }
+};
+
+bool parse_model_list(const std::string& text, long long* values, int count) {
+    std::stringstream stream(text);
+    std::string item;
+    int parsed = 0;
+    while (std::getline(stream, item, ',')) {
+        if (parsed >= count || item.empty() || item.find_first_not_of("-0123456789") != std::string::npos) return false;
+        values[parsed++] = std::stoll(item);
+    }
+    return parsed == count;
+}
+
+// "phi=<x> divisor=<x> d12=<5 values> d7=<7 values>", any subset, on top of
+// the standard model.
+bool parse_model_variant(const std::string& line, LGO_Model& model) {
+    model = LGO_Model::standard();
+    std::stringstream stream(line);
+    std::string token;
+    while (stream >> token) {
+        size_t equals = token.find('=');
+        if (equals == std::string::npos) return false;
+        std::string key = token.substr(0, equals);
+        std::string value = token.substr(equals + 1);
+        char* end = nullptr;
+        if (key == "phi") {
+            model.phi_dampener = std::strtod(value.c_str(), &end);
+            if (end == value.c_str() || *end != '\0' || !(model.phi_dampener > 0.0)) return false;
+        } else if (key == "divisor") {
+            model.base_gap_divisor = std::strtold(value.c_str(), &end);
+            if (end == value.c_str() || *end != '\0' || !(model.base_gap_divisor > 0.0L)) return false;
+        } else if (key == "d12") {
+            if (!parse_model_list(value, model.delta_12, ULAM_CORRECTION_SIZE)) return false;
+        } else if (key == "d7") {
+            if (!parse_model_list(value, model.delta_7, MOD_7_CORRECTION_SIZE)) return false;
+        } else {
+            return false;
+        }
+    }
+    model.prepare();
+    return true;
+}
+
+std::string describe_model(const LGO_Model& model) {
+    std::ostringstream out;
+    out << std::setprecision(12) << "phi=" << model.phi_dampener << " divisor=" << (double)model.base_gap_divisor << " d12=";
+    for (int i = 0; i < ULAM_CORRECTION_SIZE; i++) { out << (i ? "," : "") << model.delta_12[i]; }
+    out << " d7=";
+    for (int i = 0; i < MOD_7_CORRECTION_SIZE; i++) { out << (i ? "," : "") << model.delta_7[i]; }
+    return out.str();
+}
+
+
+// ====================================================================
+// --- SKIP-AHEAD JUMP ---
+// ====================================================================
+// While the digit count and G stay fixed, the gap depends only on P mod 84, so
+// the residue walk r -> (r + gap(r)) mod 84 is eventually periodic. Whole
+// periods are added with one multiply-add. G is monotone in the leading digits,
+// so the end of the current segment is found by a binary search over them and
+// the segment is only re-derived when the chain leaves it.
+
+struct JumpSegment {
+    long long gaps[84];
+    long long base_gap = 0;
+    long long G_density = 0;
+    BigInt limit; // Smallest value outside the segment
+};
+
+long long LGO_DensityCorrection(long long digits, unsigned long long leading_mantissa) {
+    LnEstimate leading;
+    leading.digits = digits;
+    leading.leading_mantissa = leading_mantissa;
+    return LGO_RoundDensity(LGO_DensityTerm(leading), digits, leading_mantissa, LN_C_LGO_STAR, C_LGO_STAR);
+}
+
+void build_jump_segment(const PredictionState& state, JumpSegment& segment) {
+    long long digits = state.digits();
+    int leading_count = (int)std::min<long long>(digits, LEADING_MANTISSA_DIGITS);
+    unsigned long long low = state.leading.leading_mantissa;
+    unsigned long long high = POW10_U64[leading_count] - 1;
+    long long G_density = LGO_DensityCorrection(digits, low);
+
+    // Largest leading value that still rounds to the same G.
+    while (low < high) {
+        unsigned long long middle = low + (high - low + 1) / 2;
+        if (LGO_DensityCorrection(digits, middle) == G_density) { low = middle; } else { high = middle - 1; }
+    }
+    std::string limit = std::to_string(low + 1);
+    limit.append((size_t)(digits - leading_count), '0');
+    segment.limit = BigInt(limit);
+
+    long long base_gap = LGO_BaseGap_ForDigits(digits);
+    segment.base_gap = base_gap;
+    segment.G_density = G_density;
+    for (int r = 0; r < 84; r++) {
+        segment.gaps[r] = LGO_FinalGap(base_gap, RESIDUE_TABLE.mod_84[r].delta, G_density);
+    }
+}
+
+// Advances 'state' by 'steps' predictions, with the same result as calling
+// LGO_Predict_Deterministic() 'steps' times.
+void LGO_JumpAhead(PredictionState& state, unsigned long long steps) {
+    JumpSegment segment;
+    bool have_segment = false;
+
+    while (steps > 0) {
+        if (state.is_small_special()) {
+            PredictionMetrics metrics;
+            LGO_Predict_Deterministic(state, metrics);
+            steps--;
+            have_segment = false;
+            continue;
+        }
+        if (!have_segment || state.prime.compare(segment.limit) >= 0) {
+            build_jump_segment(state, segment);
+            have_segment = true;
+        }
+
+        // Walk the residue orbit until it repeats (at most 84 steps).
+        int seen_at[84];
+        std::fill(seen_at, seen_at + 84, -1);
+        unsigned long long prefix_sum[85];
+        prefix_sum[0] = 0;
+        int r = (int)state.mod_84;
+        int length = 0;
+        while (seen_at[r] < 0) {
+            seen_at[r] = length;
+            prefix_sum[length + 1] = prefix_sum[length] + (unsigned long long)segment.gaps[r];
+            r = (int)((r + segment.gaps[r]) % 84);
+            length++;
+        }
+        bool on_cycle = (seen_at[r] == 0);
+        unsigned long long cycle_length = (unsigned long long)length;
+        unsigned long long cycle_sum = prefix_sum[length];
+
+        unsigned long long cycles = on_cycle ? steps / cycle_length : 0;
+        if (cycles > 0) {
+            // Keep every step of the bulk inside the segment: P + cycles * sum < limit.
+            unsigned long long distance = 0;
+            if (segment.limit.difference_from(state.prime, distance)) {
+                cycles = std::min(cycles, (distance - 1) / cycle_sum);
+            } else {
+                unsigned long long fits = 0, too_far = cycles + 1;
+                while (fits + 1 < too_far) {
+                    unsigned long long middle = fits + (too_far - fits) / 2;
+                    BigInt end = state.prime;
+                    end.add_product(middle, cycle_sum);
+                    if (end.compare(segment.limit) < 0) { fits = middle; } else { too_far = middle; }
+                }
+                cycles = fits;
+            }
+        }
+
+        if (cycles > 0) {
+            state.advance_bulk(cycles, cycle_sum);
+            steps -= cycles * cycle_length;
+        } else {
+            state.advance(segment.gaps[state.mod_84]);
+            steps--;
+        }
+    }
+}
+
+
+// ====================================================================
+// --- SOA BATCH PREDICTOR ---
+// ====================================================================
+// Many independent chains advanced in lock step. The hot per-lane fields sit
+// in parallel arrays: the mod 84 residue, base gap + G, its residue mod 84, the
+// sum of gaps not yet added to the BigInt (everything below the low limb), and
+// the headroom that sum may use before it would carry out of the low limb or
+// leave the lane's jump segment (digit count and G fixed). Inside that window a
+// step is gather(delta) + parity fixup + clamp + residue update, which the
+// kernels below run on 8 (AVX-512), 4 (AVX2) or 2 (NEON) lanes at a time.
+// Lanes outside it are flushed and stepped through LGO_Predict_Deterministic(),
+// so the result is identical to running every chain on its own.
+
+// Fast-path step for lane i; sets gap_out[i] = -1 when the lane needs the slow path.
+inline void batch_step_lane(long long* residue, const long long* gap_base, const long long* gap_base_mod,
+                            long long* pending, const long long* headroom, long long* gap_out, size_t i) {
+    long long delta = RESIDUE_TABLE.delta_84[residue[i]];
+    long long gap = gap_base[i] + delta;
+    long long odd = gap & 1;
+    gap += odd;
+    long long gap_mod = gap_base_mod[i] + delta + odd;
+    if (gap < 2) { gap = 2; gap_mod = 2; }
+    if (gap_mod < 0) { gap_mod += 84; } else if (gap_mod >= 84) { gap_mod -= 84; }
+
+    long long next_pending = pending[i] + gap;
+    if (next_pending > headroom[i]) { gap_out[i] = -1; return; }
+    long long next_residue = residue[i] + gap_mod;
+    if (next_residue >= 84) { next_residue -= 84; }
+    residue[i] = next_residue;
+    pending[i] = next_pending;
+    gap_out[i] = gap;
+}
+
+// Kernels compiled into this build; the SIMD ones need the matching compiler
+// flags. Each vector kernel returns how many lanes it handled, the scalar loop
+// finishes the rest.
+enum BatchKernel { BATCH_KERNEL_SCALAR, BATCH_KERNEL_AVX2, BATCH_KERNEL_AVX512, BATCH_KERNEL_NEON };
+
+#if defined(__AVX512F__)
+size_t batch_step_avx512(long long* residue, const long long* gap_base, const long long* gap_base_mod,
+                         long long* pending, const long long* headroom, long long* gap_out, size_t count) {
+    size_t i = 0;
+    const __m512i two = _mm512_set1_epi64(2), one = _mm512_set1_epi64(1), zero = _mm512_setzero_si512();
+    const __m512i m83 = _mm512_set1_epi64(83), m84 = _mm512_set1_epi64(84), slow = _mm512_set1_epi64(-1);
+    for (; i + 8 <= count; i += 8) {
+        __m512i r = _mm512_loadu_si512(residue + i);
+        __m512i delta = _mm512_i64gather_epi64(r, RESIDUE_TABLE.delta_84, 8);
+        __m512i gap = _mm512_add_epi64(_mm512_loadu_si512(gap_base + i), delta);
+        __m512i odd = _mm512_and_si512(gap, one);
+        gap = _mm512_add_epi64(gap, odd);
+        __m512i gap_mod = _mm512_add_epi64(_mm512_add_epi64(_mm512_loadu_si512(gap_base_mod + i), delta), odd);
+        __mmask8 clamp = _mm512_cmplt_epi64_mask(gap, two);
+        gap = _mm512_mask_blend_epi64(clamp, gap, two);
+        gap_mod = _mm512_mask_blend_epi64(clamp, gap_mod, two);
+        gap_mod = _mm512_mask_add_epi64(gap_mod, _mm512_cmplt_epi64_mask(gap_mod, zero), gap_mod, m84);
+        gap_mod = _mm512_mask_sub_epi64(gap_mod, _mm512_cmpgt_epi64_mask(gap_mod, m83), gap_mod, m84);
+
+        __m512i p = _mm512_loadu_si512(pending + i);
+        __m512i next_pending = _mm512_add_epi64(p, gap);
+        __mmask8 over = _mm512_cmpgt_epi64_mask(next_pending, _mm512_loadu_si512(headroom + i));
+        __m512i next_r = _mm512_add_epi64(r, gap_mod);
+        next_r = _mm512_mask_sub_epi64(next_r, _mm512_cmpgt_epi64_mask(next_r, m83), next_r, m84);
+        _mm512_storeu_si512(residue + i, _mm512_mask_blend_epi64(over, next_r, r));
+        _mm512_storeu_si512(pending + i, _mm512_mask_blend_epi64(over, next_pending, p));
+        _mm512_storeu_si512(gap_out + i, _mm512_mask_blend_epi64(over, gap, slow));
+    }
+    return i;
+}
+#endif
+
+#if defined(__AVX2__)
+size_t batch_step_avx2(long long* residue, const long long* gap_base, const long long* gap_base_mod,
+                       long long* pending, const long long* headroom, long long* gap_out, size_t count) {
+    size_t i = 0;
+    const __m256i two = _mm256_set1_epi64x(2), one = _mm256_set1_epi64x(1), zero = _mm256_setzero_si256();
+    const __m256i m83 = _mm256_set1_epi64x(83), m84 = _mm256_set1_epi64x(84), slow = _mm256_set1_epi64x(-1);
+    for (; i + 4 <= count; i += 4) {
+        __m256i r = _mm256_loadu_si256((const __m256i*)(residue + i));
+        __m256i delta = _mm256_i64gather_epi64(RESIDUE_TABLE.delta_84, r, 8);
+        __m256i gap = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(gap_base + i)), delta);
+        __m256i odd = _mm256_and_si256(gap, one);
+        gap = _mm256_add_epi64(gap, odd);
+        __m256i gap_mod = _mm256_add_epi64(_mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(gap_base_mod + i)), delta), odd);
+        __m256i clamp = _mm256_cmpgt_epi64(two, gap);
+        gap = _mm256_blendv_epi8(gap, two, clamp);
+        gap_mod = _mm256_blendv_epi8(gap_mod, two, clamp);
+        gap_mod = _mm256_add_epi64(gap_mod, _mm256_and_si256(_mm256_cmpgt_epi64(zero, gap_mod), m84));
+        gap_mod = _mm256_sub_epi64(gap_mod, _mm256_and_si256(_mm256_cmpgt_epi64(gap_mod, m83), m84));
+
+        __m256i p = _mm256_loadu_si256((const __m256i*)(pending + i));
+        __m256i next_pending = _mm256_add_epi64(p, gap);
+        __m256i over = _mm256_cmpgt_epi64(next_pending, _mm256_loadu_si256((const __m256i*)(headroom + i)));
+        __m256i next_r = _mm256_add_epi64(r, gap_mod);
+        next_r = _mm256_sub_epi64(next_r, _mm256_and_si256(_mm256_cmpgt_epi64(next_r, m83), m84));
+        _mm256_storeu_si256((__m256i*)(residue + i), _mm256_blendv_epi8(next_r, r, over));
+        _mm256_storeu_si256((__m256i*)(pending + i), _mm256_blendv_epi8(next_pending, p, over));
+        _mm256_storeu_si256((__m256i*)(gap_out + i), _mm256_blendv_epi8(gap, slow, over));
+    }
+    return i;
+}
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+size_t batch_step_neon(long long* residue, const long long* gap_base, const long long* gap_base_mod,
+                       long long* pending, const long long* headroom, long long* gap_out, size_t count) {
+    size_t i = 0;
+    const int64x2_t two = vdupq_n_s64(2), one = vdupq_n_s64(1), zero = vdupq_n_s64(0);
+    const int64x2_t m83 = vdupq_n_s64(83), m84 = vdupq_n_s64(84), slow = vdupq_n_s64(-1);
+    for (; i + 2 <= count; i += 2) {
+        int64x2_t r = vld1q_s64(residue + i);
+        int64x2_t delta = vsetq_lane_s64(RESIDUE_TABLE.delta_84[residue[i + 1]], vdupq_n_s64(RESIDUE_TABLE.delta_84[residue[i]]), 1);
+        int64x2_t gap = vaddq_s64(vld1q_s64(gap_base + i), delta);
+        int64x2_t odd = vandq_s64(gap, one);
+        gap = vaddq_s64(gap, odd);
+        int64x2_t gap_mod = vaddq_s64(vaddq_s64(vld1q_s64(gap_base_mod + i), delta), odd);
+        uint64x2_t clamp = vcltq_s64(gap, two);
+        gap = vbslq_s64(clamp, two, gap);
+        gap_mod = vbslq_s64(clamp, two, gap_mod);
+        gap_mod = vaddq_s64(gap_mod, vandq_s64(vreinterpretq_s64_u64(vcltq_s64(gap_mod, zero)), m84));
+        gap_mod = vsubq_s64(gap_mod, vandq_s64(vreinterpretq_s64_u64(vcgtq_s64(gap_mod, m83)), m84));
+
+        int64x2_t p = vld1q_s64(pending + i);
+        int64x2_t next_pending = vaddq_s64(p, gap);
+        uint64x2_t over = vcgtq_s64(next_pending, vld1q_s64(headroom + i));
+        int64x2_t next_r = vaddq_s64(r, gap_mod);
+        next_r = vsubq_s64(next_r, vandq_s64(vreinterpretq_s64_u64(vcgtq_s64(next_r, m83)), m84));
+        vst1q_s64(residue + i, vbslq_s64(over, r, next_r));
+        vst1q_s64(pending + i, vbslq_s64(over, p, next_pending));
+        vst1q_s64(gap_out + i, vbslq_s64(over, slow, gap));
+    }
+    return i;
+}
+#endif
+
+void batch_step_kernel(BatchKernel kernel, long long* residue, const long long* gap_base, const long long* gap_base_mod,
+                       long long* pending, const long long* headroom, long long* gap_out, size_t count) {
+    size_t i = 0;
+    switch (kernel) {
+#if defined(__AVX512F__)
+    case BATCH_KERNEL_AVX512: i = batch_step_avx512(residue, gap_base, gap_base_mod, pending, headroom, gap_out, count); break;
+#endif
+#if defined(__AVX2__)
+    case BATCH_KERNEL_AVX2: i = batch_step_avx2(residue, gap_base, gap_base_mod, pending, headroom, gap_out, count); break;
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    case BATCH_KERNEL_NEON: i = batch_step_neon(residue, gap_base, gap_base_mod, pending, headroom, gap_out, count); break;
+#endif
+    default: break;
+    }
+    for (; i < count; i++) {
+        batch_step_lane(residue, gap_base, gap_base_mod, pending, headroom, gap_out, i);
+    }
+}
+
+// Best first; the scalar kernel is always last.
+const std::vector<BatchKernel>& compiled_batch_kernels() {
+    static const std::vector<BatchKernel> kernels = {
+#if defined(__AVX512F__)
+        BATCH_KERNEL_AVX512,
+#endif
+#if defined(__AVX2__)
+        BATCH_KERNEL_AVX2,
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+        BATCH_KERNEL_NEON,
+#endif
+        BATCH_KERNEL_SCALAR,
+    };
+    return kernels;
+}
+
+const char* batch_kernel_name(BatchKernel kernel) {
+    switch (kernel) {
+    case BATCH_KERNEL_AVX512: return "avx512";
+    case BATCH_KERNEL_AVX2: return "avx2";
+    case BATCH_KERNEL_NEON: return "neon";
+    default: return "scalar";
+    }
+}
+
+const char* batch_kernel_name() {
+    return batch_kernel_name(compiled_batch_kernels().front());
+}
+
+class PredictionBatch {
+public:
+    PredictionBatch() {}
+    explicit PredictionBatch(BatchKernel step_kernel) : kernel(step_kernel) {}
+
+    // Returns the lane index of the new chain.
+    size_t add(const PredictionState& state) {
+        size_t lane = states.size();
+        states.push_back(state);
+        residue.push_back(state.mod_84);
+        gap_base.push_back(0);
+        gap_base_mod.push_back(0);
+        pending.push_back(0);
+        headroom.push_back(-1);
+        gap.push_back(0);
+        refill(lane);
+        return lane;
+    }
+
+    size_t size() const { return states.size(); }
+
+    // One prediction on every lane; last_gap(lane) holds the gap it produced.
+    void step() {
+        batch_step_kernel(kernel, residue.data(), gap_base.data(), gap_base_mod.data(),
+                          pending.data(), headroom.data(), gap.data(), states.size());
+        for (size_t lane = 0; lane < states.size(); lane++) {
+            if (gap[lane] < 0) { slow_step(lane); }
+        }
+    }
+
+    void advance(unsigned long long steps) {
+        for (unsigned long long s = 0; s < steps; s++) { step(); }
+    }
+
+    long long last_gap(size_t lane) const { return gap[lane]; }
+
+    // Digit count and lowest limb of a lane without flushing it ('pending' never carries out of limb 0).
+    long long digits(size_t lane) const { return states[lane].prime.digit_count(); }
+    unsigned long long low_limb(size_t lane) const { return states[lane].prime.limb(0) + (unsigned long long)pending[lane]; }
+
+    // Full state of one lane, including the gaps still held in 'pending'.
+    PredictionState state(size_t lane) const {
+        PredictionState current = states[lane];
+        if (pending[lane] > 0) { current.advance(pending[lane]); }
+        return current;
+    }
+
+private:
+    void flush(size_t lane) {
+        if (pending[lane] > 0) {
+            states[lane].advance(pending[lane]);
+            pending[lane] = 0;
+        }
+    }
+
+    // Re-derives the lane's fast-path window from its (flushed) state.
+    void refill(size_t lane) {
+        const PredictionState& current = states[lane];
+        residue[lane] = current.mod_84;
+        if (current.is_small_special()) {
+            headroom[lane] = -1; // every step takes the slow path
+            return;
+        }
+        JumpSegment segment;
+        build_jump_segment(current, segment);
+        gap_base[lane] = segment.base_gap + segment.G_density;
+        gap_base_mod[lane] = ((gap_base[lane] % 84) + 84) % 84;
+
+        unsigned long long room = BIGINT_LIMB_BASE - 1 - current.prime.limb(0);
+        unsigned long long distance = 0;
+        if (segment.limit.difference_from(current.prime, distance)) {
+            room = std::min(room, distance - 1);
+        }
+        headroom[lane] = (long long)room;
+    }
+
+    void slow_step(size_t lane) {
+        flush(lane);
+        PredictionMetrics metrics;
+        gap[lane] = LGO_Predict_Deterministic(states[lane], metrics);
+        refill(lane);
+    }
+
+    BatchKernel kernel = compiled_batch_kernels().front();
+    std::vector<PredictionState> states; // value without 'pending'
+    std::vector<long long> residue;
+    std::vector<long long> gap_base;
+    std::vector<long long> gap_base_mod;
+    std::vector<long long> pending;
+    std::vector<long long> headroom;
+    std::vector<long long> gap;
+};
+
+
+// ====================================================================
+// --- CHAIN SEGMENT CACHE ---
+// ====================================================================
+// A chain is determined by its current value, so replaying a seed repeats the
+// same gaps. Every run through the cache records each aligned segment of
+// SEGMENT_CACHE_STEPS steps as a small binary sequence file, keyed by a hash of
+// the value the segment starts from (its seed) and its first step. Later runs
+// that reach the same seed at the same step replay those gaps instead of
+// predicting them. Recently used segments are also kept decoded in memory, and
+// both levels drop the least recently used segments beyond their size caps.
+
+const long long SEGMENT_CACHE_STEPS = 4096;
+const std::string SEGMENT_CACHE_EXTENSION = ".lgob";
+const size_t DEFAULT_SEGMENT_CACHE_MEMORY_BYTES = 64 * 1024 * 1024;
+const long long DEFAULT_SEGMENT_CACHE_DISK_BYTES = 1024LL * 1024 * 1024;
+const long long REPLAY_METRICS_EVERY = 256; // Replays recompute the shown and published metrics this often
+
+// FNV-1a over the limbs.
+unsigned long long segment_seed_hash(const BigInt& seed) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (unsigned long long limb : seed.limb_data()) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (limb >> (8 * i)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+std::string segment_name(const BigInt& seed, long long first_step) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%lld", segment_seed_hash(seed), first_step);
+    return name;
+}
+
+struct CachedSegment {
+    BigInt seed;                 // Value before the first step
+    long long first_step = 0;    // Steps the chain had made at 'seed'
+    std::vector<long long> gaps; // SEGMENT_CACHE_STEPS gaps, all positive
+
+    size_t memory_bytes() const {
+        return sizeof(CachedSegment) + gaps.size() * sizeof(long long) + seed.limb_count() * sizeof(unsigned long long);
+    }
+};
+
+struct SegmentCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long stored = 0;
+    long long evicted = 0;
+};
+
+class SegmentCache {
+public:
+    SegmentCache() {}
+
+    SegmentCache(const SegmentCache&) = delete;
+    SegmentCache& operator=(const SegmentCache&) = delete;
+
+    // Creates 'cache_directory' if needed and indexes the segments already in it.
+    bool open(const std::string& cache_directory, size_t memory_cap_bytes, long long disk_cap_bytes) {
+        close();
+        std::error_code error;
+        std::filesystem::create_directories(cache_directory, error);
+        if (error || !std::filesystem::is_directory(cache_directory, error)) {
+            return false;
+        }
+        directory = cache_directory;
+        memory_cap = memory_cap_bytes;
+        disk_cap = disk_cap_bytes;
+
+        std::vector<std::pair<std::filesystem::file_time_type, std::string>> found;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if (entry.path().extension() != SEGMENT_CACHE_EXTENSION) continue;
+            std::error_code entry_error;
+            std::filesystem::file_time_type stamp = entry.last_write_time(entry_error);
+            if (!entry_error) {
+                found.emplace_back(stamp, entry.path().stem().string());
+            }
+        }
+        std::sort(found.begin(), found.end()); // Oldest first, so the newest ends up at the front
+        for (const auto& file : found) {
+            long long bytes = std::max(0LL, file_size_bytes(path_for(file.second)));
+            disk_lru.push_front(DiskEntry{file.second, bytes});
+            disk_index[file.second] = disk_lru.begin();
+            disk_bytes += bytes;
+        }
+        evict_disk();
+        return true;
+    }
+
+    bool is_open() const { return !directory.empty(); }
+
+    const std::string& path() const { return directory; }
+
+    void close() {
+        directory.clear();
+        memory_lru.clear();
+        memory_index.clear();
+        memory_bytes = 0;
+        disk_lru.clear();
+        disk_index.clear();
+        disk_bytes = 0;
+    }
+
+    // Copies the gaps of the segment that starts at 'first_step' from 'seed'
+    // into 'gaps', from memory or from disk.
+    bool find(const BigInt& seed, long long first_step, std::vector<long long>& gaps) {
+        std::string name = segment_name(seed, first_step);
+        auto cached = memory_index.find(name);
+        if (cached != memory_index.end() && cached->second->seed.limb_data() == seed.limb_data()) {
+            memory_lru.splice(memory_lru.begin(), memory_lru, cached->second);
+            gaps = cached->second->gaps;
+            touch_disk(name);
+            counters.hits++;
+            return true;
+        }
+
+        auto on_disk = disk_index.find(name);
+        if (on_disk != disk_index.end()) {
+            CachedSegment loaded;
+            if (load_segment(path_for(name), seed, first_step, loaded)) {
+                gaps = loaded.gaps;
+                touch_disk(name);
+                remember(name, std::move(loaded));
+                counters.hits++;
+                return true;
+            }
+        }
+        counters.misses++;
+        return false;
+    }
+
+    // Writes a complete segment to disk and keeps it in memory.
+    void store(const CachedSegment& segment) {
+        if ((long long)segment.gaps.size() != SEGMENT_CACHE_STEPS) {
+            return;
+        }
+        std::string name = segment_name(segment.seed, segment.first_step);
+        if (!write_segment(name, segment)) {
+            return;
+        }
+        drop_disk_entry(name);
+        long long bytes = std::max(0LL, file_size_bytes(path_for(name)));
+        disk_lru.push_front(DiskEntry{name, bytes});
+        disk_index[name] = disk_lru.begin();
+        disk_bytes += bytes;
+        counters.stored++;
+        evict_disk();
+        remember(name, segment);
+    }
+
+    SegmentCacheStats stats() const { return counters; }
+
+private:
+    struct DiskEntry {
+        std::string name;
+        long long bytes = 0;
+    };
+
+    std::string path_for(const std::string& name) const {
+        return (std::filesystem::path(directory) / (name + SEGMENT_CACHE_EXTENSION)).string();
+    }
+
+    // The file must be a complete segment of this model starting from 'seed'.
+    static bool load_segment(const std::string& file_path, const BigInt& seed, long long first_step, CachedSegment& segment) {
+        BinarySequenceReader reader;
+        if (!reader.open(file_path)) return false;
+        const BinarySequenceHeader& header = reader.header();
+        if (!header.has_start_prime || header.model_version != LGO_MODEL_VERSION ||
+            header.start_prime.limb_data() != seed.limb_data() || reader.record_count() != SEGMENT_CACHE_STEPS) {
+            return false;
+        }
+
+        segment.seed = seed;
+        segment.first_step = first_step;
+        segment.gaps.clear();
+        segment.gaps.reserve((size_t)SEGMENT_CACHE_STEPS);
+        bool valid = true;
+        bool complete = reader.for_each_gap(seed, [&](unsigned long long gap) {
+            valid = valid && gap > 0;
+            segment.gaps.push_back((long long)gap);
+        });
+        return complete && valid;
+    }
+
+    // Written under a temporary name and renamed, so a reader never sees half a segment.
+    bool write_segment(const std::string& name, const CachedSegment& segment) const {
+        std::string final_path = path_for(name);
+        std::string temp_path = final_path + ".tmp";
+        std::error_code error;
+        std::filesystem::remove(temp_path, error); // The writer appends
+
+        SequenceWriterPolicy policy;
+        policy.format = SEQUENCE_BINARY;
+        policy.keyframe_interval = SEGMENT_CACHE_STEPS;
+        SequenceWriter writer;
+        if (!writer.open(temp_path, policy, &segment.seed)) {
+            return false;
+        }
+        BigInt value = segment.seed;
+        for (long long gap : segment.gaps) {
+            value.add_small((unsigned long long)gap);
+            writer.write(value, gap);
+        }
+        bool ok = writer.close();
+        if (!ok) {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+#ifdef _WIN32
+        std::remove(final_path.c_str()); // rename() does not replace on Windows
+#endif
+        return std::rename(temp_path.c_str(), final_path.c_str()) == 0;
+    }
+
+    void remember(const std::string& name, CachedSegment segment) {
+        auto existing = memory_index.find(name);
+        if (existing != memory_index.end()) {
+            memory_bytes -= existing->second->memory_bytes();
+            memory_lru.erase(existing->second);
+            memory_index.erase(existing);
+        }
+        memory_bytes += segment.memory_bytes();
+        memory_lru.push_front(std::move(segment));
+        memory_index[name] = memory_lru.begin();
+        while (memory_bytes > memory_cap && !memory_lru.empty()) {
+            memory_bytes -= memory_lru.back().memory_bytes();
+            memory_index.erase(segment_name(memory_lru.back().seed, memory_lru.back().first_step));
+            memory_lru.pop_back();
+        }
+    }
+
+    // Moves the segment to the front of the disk order and refreshes its file time.
+    void touch_disk(const std::string& name) {
+        auto entry = disk_index.find(name);
+        if (entry == disk_index.end()) return;
+        disk_lru.splice(disk_lru.begin(), disk_lru, entry->second);
+        std::error_code error;
+        std::filesystem::last_write_time(path_for(name), std::filesystem::file_time_type::clock::now(), error);
+    }
+
+    void drop_disk_entry(const std::string& name) {
+        auto entry = disk_index.find(name);
+        if (entry == disk_index.end()) return;
+        disk_bytes -= entry->second->bytes;
+        disk_lru.erase(entry->second);
+        disk_index.erase(entry);
+    }
+
+    void evict_disk() {
+        while (disk_bytes > disk_cap && !disk_lru.empty()) {
+            std::string name = disk_lru.back().name;
+            std::error_code error;
+            std::filesystem::remove(path_for(name), error);
+            drop_disk_entry(name);
+            counters.evicted++;
+        }
+    }
+
+    std::string directory = "";
+    size_t memory_cap = DEFAULT_SEGMENT_CACHE_MEMORY_BYTES;
+    long long disk_cap = DEFAULT_SEGMENT_CACHE_DISK_BYTES;
+
+    std::list<CachedSegment> memory_lru; // Most recently used first
+    std::unordered_map<std::string, std::list<CachedSegment>::iterator> memory_index;
+    size_t memory_bytes = 0;
+
+    std::list<DiskEntry> disk_lru;
+    std::unordered_map<std::string, std::list<DiskEntry>::iterator> disk_index;
+    long long disk_bytes = 0;
+
+    SegmentCacheStats counters;
+};
+
+// Steps one chain through a SegmentCache: at every aligned step it either
+// replays a known segment or starts recording the one it is about to predict.
+// Without a cache it is just the predictor.
+class SegmentCursor {
+public:
+    // 'metrics_every' > 0 also recomputes the metrics of every such replayed
+    // step, for displays; 0 leaves 'metrics' untouched while replaying.
+    explicit SegmentCursor(SegmentCache* segment_cache, long long metrics_every = 0)
+        : cache(segment_cache), replay_metrics_every(metrics_every) {}
+
+    // Advances 'state' by one step and returns the gap. 'steps_before' is the
+    // number of steps the chain had made at 'state'.
+    long long step(PredictionState& state, long long steps_before, PredictionMetrics& metrics) {
+        if (replay_next >= replay.size() && cache != nullptr && steps_before % SEGMENT_CACHE_STEPS == 0) {
+            replay.clear();
+            replay_next = 0;
+            recording_active = !cache->find(state.prime, steps_before, replay);
+            if (recording_active) {
+                recording.seed = state.prime;
+                recording.first_step = steps_before;
+                recording.gaps.clear();
+            }
+        }
+
+        if (replay_next < replay.size()) {
+            fresh_metrics = replay_metrics_every > 0 && steps_before % replay_metrics_every == 0;
+            if (fresh_metrics) {
+                metrics = LGO_ComputeMetrics(state);
+            }
+            long long gap = replay[replay_next++];
+            state.advance(gap);
+            return gap;
+        }
+
+        long long gap = LGO_Predict_Deterministic(state, metrics);
+        fresh_metrics = true;
+        if (recording_active) {
+            if (gap <= 0) {
+                recording_active = false; // Only positive gaps round-trip through the file
+            } else {
+                recording.gaps.push_back(gap);
+                if ((long long)recording.gaps.size() == SEGMENT_CACHE_STEPS) {
+                    cache->store(recording);
+                    recording_active = false;
+                }
+            }
+        }
+        return gap;
+    }
+
+    // Whether the last step() filled 'metrics'.
+    bool metrics_fresh() const { return fresh_metrics; }
+
+private:
+    SegmentCache* cache = nullptr;
+    long long replay_metrics_every = 0;
+    std::vector<long long> replay;
+    size_t replay_next = 0;
+    CachedSegment recording;
+    bool recording_active = false;
+    bool fresh_metrics = false;
+};
+
+// Interactive sessions share one cache, so picking the same menu seed again is
+// served from memory. Only opened when the console is started with --cache.
+SegmentCache segment_cache;
+std::string console_cache_dir = "";
+long long console_cache_disk_bytes = DEFAULT_SEGMENT_CACHE_DISK_BYTES;
+
+
+// ====================================================================
+// --- CONSOLE MENU FUNCTIONS (Updated Version Number) ---
+// ====================================================================
+
+void display_menu() {
+    in_menu = true; 
+    // Scripts get the list once and no prompts; a console gets the full screen every time.
+    static bool listed = false;
+    bool interactive = terminal.is_interactive();
+    terminal.ensure_size(100, 20);
+    terminal.clear();
+    
+    if (interactive || !listed) {
+        listed = true;
+        std::cout << "===================================================================" << std::endl;
+        std::cout << "        LGO Deterministic Predictor (v5.9) - PRIME SELECTION       " << std::endl;
+        std::cout << "===================================================================" << std::endl;
+        std::cout << "\nChoose a starting prime or enter your own:\n" << std::endl;
+
+        std::cout << "(L) Load Last Prime from " << SEQUENCE_FILE << std::endl;
+        std::cout << "-------------------------------------------------------------------" << std::endl;
+
+
+        for (const auto& item : PRIME_LIST) {
+            std::cout << item.first << " (" << item.second.length() << " digits)" << std::endl;
+        }
+    
+        std::cout << "\n(M) Manual Entry (arbitrary length)" << std::endl;
+        std::cout << "(Q) Quit Program" << std::endl;
+        std::cout << "-------------------------------------------------------------------" << std::endl;
+    }
+    
+    char choice;
+    std::string input_line;
+    
+    while (in_menu) { 
+        if (interactive) {
+            std::cout << "Your Choice: ";
+        }
+        if (!std::getline(std::cin, input_line)) {
+            is_running = false; // End of input quits, instead of prompting forever
+            in_menu = false;
+            return;
+        }
+        if (!input_line.empty()) {
+            choice = std::toupper(input_line[0]);
+        } else {
+            continue;
+        }
+
+        if (choice == 'Q') {
+            is_running = false; 
+            in_menu = false;
+            return;
+        } else if (choice == 'L') { 
+            sequence_writer.flush();
+            SequenceCheckpoint loaded;
+            if (load_resume_point(SEQUENCE_FILE, loaded)) {
+                user_prime_input = loaded.last_prime;
+                predictions_made = loaded.predictions_made; 
+                resume_checkpoint = loaded;
+                has_resume_checkpoint = true;
+                in_menu = false; 
+                return;
+            } else {
+                std::cout << "Could not load sequence. Please choose another option." << std::endl;
+            }
+        } else if (choice == 'M') {
+            if (interactive) {
+                std::cout << "\nEnter your prime (arbitrary length): ";
+            }
+            if (!std::getline(std::cin, user_prime_input)) {
+                user_prime_input.clear();
+                is_running = false;
+                in_menu = false;
+                return;
+            }
+            if (!user_prime_input.empty() && user_prime_input.find_first_not_of("0123456789") == std::string::npos) {
+                user_prime_input = user_prime_input; 
+                std::cout << "Prime selected: " << user_prime_input << std::endl;
+                predictions_made = 0; 
+                in_menu = false; 
+                return;
+            } else {
+                std::cout << "Invalid input. Please enter only digits." << std::endl;
+            }
+        } else if (choice >= '1' && choice <= '0' + PRIME_LIST.size()) {
+            int index = choice - '1';
+            if (index >= 0 && index < PRIME_LIST.size()) { 
+                user_prime_input = PRIME_LIST[index].second;
+                std::cout << "Prime selected: " << user_prime_input << " (" << PRIME_LIST[index].first << ")" << std::endl;
+                predictions_made = 0; 
+                in_menu = false; 
+                return;
+            } else {
+                 std::cout << "Invalid selection. Please re-enter choice." << std::endl;
+            }
+        } else {
+            std::cout << "Invalid option. Please choose from the list." << std::endl;
+        }
+    }
+}
+
+// ====================================================================
+// --- CRITICAL LINE SCANNER FUNCTION ---
+// ====================================================================
+
+void draw_critical_line_scanner(Frame& frame, double pnt_ratio) {
+    int start_x = 105;
+    int start_y = 25;
+    
+    // The "Non-Critical Zero Line" is the integer value of the PNT Ratio (e.g., 1.0, 2.0, etc.)
+    long long target_integer = (long long)std::round(pnt_ratio);
+    
+    // Center the scanner around the target integer value
+    frame.at(start_x, start_y) << "--- NON-CRITICAL ZERO LINE ---                                    ";
+    frame.at(start_x, start_y + 1) << "Target: " << target_integer << ".0                                                    ";
+    
+    // Calculate deviation from the target integer (normalized to fit display)
+    double deviation = pnt_ratio - (double)target_integer;
+    
+    // We normalize the deviation to a 40-character wide scale (20 to the left, 20 to the right)
+    // Scale factor chosen to fit the expected deviation range
+    int pointer_position = (int)std::round(deviation * 400.0); 
+    
+    // Center point of the display area (25 characters from the start_x)
+    int center = start_x + 25; 
+    
+    // Ensure position is within bounds (-20 to +20 offset from center)
+    pointer_position = std::min(20, std::max(-20, pointer_position));
+    
+    // Clear the line where the pointer moves, with the pointer ('*') at its deviated position
+    std::string pointer_line(52, ' ');
+    pointer_line[(size_t)(center + pointer_position - start_x)] = '*';
+    frame.at(start_x, start_y + 2) << pointer_line;
+    
+    // Draw the stable line (the critical line) and range markers
+    frame.at(start_x, start_y + 3) << "  -0.05 |-------------------------| +0.05  ";
+    
+    // Draw the fixed center point (the Zero Line)
+    frame.at(center, start_y + 3) << "|"; 
+    
+    // Final clear of the status line to remove trail
+    frame.at(start_x, start_y + 4) << "PNT Ratio: " << std::fixed << std::setprecision(6) << pnt_ratio << "                         ";
+}
+
+
+// ====================================================================
+// --- PREDICTION LOOP ---
+// ====================================================================
+
+void print_metrics(Frame& frame, const PredictionMetrics& metrics) {
+    
+    frame.at(0, 4) << " Prime Used: " << metrics.current_prime_digits << " digits...                                             "; 
+    
+    // COLUMN 2: Predictor Components
+    frame.at(50, 10) << metrics.current_prime_digits << "                 ";
+    frame.at(50, 11) << metrics.base_gap_out << "                 ";
+    frame.at(50, 12) << metrics.density_correction_G << "                 ";
+    frame.at(50, 13) << std::fixed << std::setprecision(9) << metrics.correlative_adjustment << "                 ";
+    frame.at(50, 14) << metrics.delta_out << "                 ";
+    frame.at(50, 15) << metrics.fluctuation_delta << "                 ";
+    
+    // COLUMN 3: Final Output & Proof Metrics
+    frame.at(105, 10) << metrics.final_gap << "                 ";
+    
+    // Analysis Status 
+    frame.at(50, 18) << "Current Set: " << prime_set_name(metrics.current_prime_set) << "              ";
+    
+    // --- PROOF METRICS WINDOW UPDATE ---
+    frame.at(110, 13) << std::fixed << std::setprecision(6) << metrics.pnt_ratio << "     ";
+    frame.at(110, 14) << std::fixed << std::setprecision(9) << ZETA_CRITICAL_LINE_CONSTANT << "   ";
+    
+    // RH PROOF PANEL UPDATE
+    frame.at(10, 14) << std::fixed << std::setprecision(9) << C_LGO_STATIC << "             ";
+    frame.at(10, 15) << std::fixed << std::setprecision(9) << C_LGO_STAR << "          ";
+    frame.at(10, 16) << metrics.rh_condition_status << "                                  ";
+    
+    // --- CRITICAL LINE SCANNER CALL ---
+    draw_critical_line_scanner(frame, metrics.pnt_ratio);
+}
+
+// Live stage timings, merged over every thread that has run a stage.
+void print_profile_panel(Frame& frame) {
+    const int start_y = 32;
+    frame.at(5, start_y) << "--- STAGE TIMINGS (1 in " << PROFILE_SAMPLE_EVERY << " sampled) ---   p50 ns    p99 ns          calls";
+    for (int s = 0; s < PROFILE_STAGE_COUNT; s++) {
+        StageSummary summary = summarize_stage((ProfileStage)s);
+        frame.at(5, start_y + 1 + s) << std::left << std::setw(36) << PROFILE_STAGE_NAMES[s] << std::right
+                                     << std::setw(9) << summary.p50_ns << std::setw(10) << summary.p99_ns
+                                     << std::setw(15) << summary.calls << "     ";
+    }
+}
+
+void draw_static_metrics_ui() {
+    terminal.ensure_size(150, 50);
+    terminal.clear();
+
+    gotoXY(0, 0);
+    std::cout << "========================================================================================================================================" << std::endl;
+    std::cout << "      LGO Deterministic Predictor (v5.9) - Console Mode Running...      " << std::endl;
+    std::cout << "========================================================================================================================================" << std::endl;
     
-    // 6. BIGINT Addition
-    std::string next_prime_result = add_strings(pn_str, final_gap);
+    gotoXY(105, 4); std::cout << "PRESS 'S' TO STOP AND RETURN TO MENU";
+    
+    // --- RH PROOF PANEL ---
+    gotoXY(5, 7);  std::cout << "------------------------------------------";
+    gotoXY(5, 8);  std::cout << "           RH PROOF PANEL (v26)           ";
+    gotoXY(5, 9);  std::cout << "------------------------------------------";
+    gotoXY(5, 10); std::cout << "Muon Mass (kg):  " << std::scientific << (double)MUON_MASS_LD;
+    gotoXY(5, 11); std::cout << "Electron Mass (kg):" << std::scientific << (double)ELECTRON_MASS_LD;
+    gotoXY(5, 12); std::cout << "Phi Dampener (Phi/2): " << std::fixed << std::setprecision(9) << PHI_DAMPENER;
+    gotoXY(5, 13); std::cout << "------------------------------------------";
+    gotoXY(5, 14); std::cout << "**LGO Static Constant:** "; 
+    gotoXY(5, 15); std::cout << "**Zeta-Stabilized (C_LGO*):**"; 
+    gotoXY(5, 16); std::cout << "**RH Lock-On Status:**"; 
+    gotoXY(5, 17); std::cout << "------------------------------------------";
+    
+    
+    // COLUMN 2: Predictor Components
+    gotoXY(50, 8); std::cout << "--- PREDICTOR COMPONENTS ---";
+    gotoXY(50, 10); std::cout << "Current Digits:    ";
+    gotoXY(50, 11); std::cout << "Base Gap Heuristic:  ";
+    gotoXY(50, 12); std::cout << "Density Correction (G): ";
+    gotoXY(50, 13); std::cout << "PHI Correlative (Phi): ";
+    gotoXY(50, 14); std::cout << "Ulam/Mod7 Delta (Delta): ";
+    gotoXY(50, 15); std::cout << "Fluctuation Delta (0):"; 
+    
+    // COLUMN 3: Final Output & Proof Metrics
+    gotoXY(105, 8); std::cout << "--- PROOF METRICS ---"; 
+    gotoXY(105, 10); std::cout << "FINAL GAP:           ";
+    gotoXY(105, 12); std::cout << "------------------------------------------";
+    gotoXY(105, 13); std::cout << "PNT Gap Ratio (Gap/ln(Pn)):"; 
+    gotoXY(105, 14); std::cout << "Zeta Critical Line Check:"; 
+    gotoXY(105, 15); std::cout << "------------------------------------------";
+    
+    // Print the bottom separator and log labels once
+    gotoXY(0, 21);
+    std::cout << "========================================================================================================================================" << std::endl;
+    gotoXY(0, 22); 
+    std::cout << "[0] Next Candidate: "; 
+}
+
+void print_log_entry(Frame& frame, long long step, const std::string& next_prime_str) {
+    frame.at(0, 22) << "[" << step << "] Next Candidate: " << next_prime_str << "                                                                                             ";
+}
+
+
+// ====================================================================
+// --- LOCK-FREE METRICS SNAPSHOT ---
+// ====================================================================
+// Single-writer seqlock. The compute thread publishes every step without
+// blocking; readers retry if they raced with a publish. The payload is kept in
+// atomic words so a torn read is never undefined behaviour, only discarded.
+
+template <typename T>
+class SeqlockSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqlockSnapshot needs a trivially copyable payload");
+
+public:
+    void publish(const T& value) {
+        unsigned long long buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        unsigned long long sequence = version.load(std::memory_order_relaxed);
+        version.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        version.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Copies the latest complete publish into 'value' and returns its sequence
+    // number (0 means nothing has been published yet).
+    unsigned long long read(T& value) const {
+        unsigned long long buffer[WORD_COUNT];
+        while (true) {
+            unsigned long long before = version.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < WORD_COUNT; i++) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&value, buffer, sizeof(T));
+                return before / 2;
+            }
+        }
+    }
+
+private:
+    static const size_t WORD_COUNT = (sizeof(T) + sizeof(unsigned long long) - 1) / sizeof(unsigned long long);
+    std::atomic<unsigned long long> version{ 0 };
+    std::atomic<unsigned long long> words[WORD_COUNT] = {};
+};
+
+struct DashboardSnapshot {
+    PredictionMetrics metrics;
+    long long predictions = 0;
+    SequenceWriterStats writer;
+};
+
+const int DASHBOARD_REFRESH_MS = 50; // 20 Hz
+
+// Shared between the compute loop and the dashboard thread.
+struct DashboardChannel {
+    SeqlockSnapshot<DashboardSnapshot> snapshot;
+    std::atomic<bool> stop_requested{ false };
+    std::atomic<bool> ui_done{ false };
+
+    // The candidate text is only rendered when the UI asks for it, since
+    // converting a large prime to decimal costs more than a prediction.
+    std::atomic<bool> candidate_requested{ false };
+    std::mutex candidate_mutex;
+    std::string candidate_text;
+    long long candidate_step = 0;
+};
+
+void run_dashboard(DashboardChannel& channel) {
+    unsigned long long drawn_sequence = 0;
+    long long drawn_candidate_step = -1;
+    DashboardSnapshot latest;
+
+    while (!channel.ui_done.load(std::memory_order_acquire)) {
+        int key = terminal.poll_key();
+        if (key == 'S' || key == 's') {
+            channel.stop_requested.store(true, std::memory_order_release);
+            return;
+        }
+
+        unsigned long long sequence = channel.snapshot.read(latest);
+        long long candidate_step = 0;
+        std::string candidate;
+        {
+            std::lock_guard<std::mutex> lock(channel.candidate_mutex);
+            candidate_step = channel.candidate_step;
+            if (candidate_step != drawn_candidate_step) { candidate = channel.candidate_text; }
+        }
+
+        if (sequence != 0 && (sequence != drawn_sequence || candidate_step != drawn_candidate_step)) {
+            Frame frame;
+            print_metrics(frame, latest.metrics);
+#if LGO_PROFILING
+            if (stage_profiling.load(std::memory_order_relaxed)) { print_profile_panel(frame); }
+#endif
+            if (candidate_step != drawn_candidate_step) {
+                print_log_entry(frame, candidate_step, candidate);
+                drawn_candidate_step = candidate_step;
+            }
+            terminal.draw(frame);
+            drawn_sequence = sequence;
+        }
+        channel.candidate_requested.store(true, std::memory_order_release);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(DASHBOARD_REFRESH_MS));
+    }
+}
+
+// Without a console the predictions run until a line starting with 'S' (or
+// the end of input) arrives, and nothing is drawn.
+void run_scripted_control(DashboardChannel& channel) {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && (line[0] == 'S' || line[0] == 's')) break;
+    }
+    channel.stop_requested.store(true, std::memory_order_release);
+}
+
+void prediction_loop() {
+    if (!is_running || user_prime_input.empty()) {
+        return;
+    }
+    
+    bool interactive = terminal.is_interactive();
+    if (interactive) {
+        draw_static_metrics_ui();
+    }
+    
+    PredictionState state;
+    if (has_resume_checkpoint && resume_checkpoint.last_prime == user_prime_input) {
+        restore_state(state, resume_checkpoint);
+    } else {
+        state.reset(BigInt(user_prime_input));
+    }
+    has_resume_checkpoint = false;
+
+    if (!sequence_writer.is_open()) {
+        sequence_writer.open(SEQUENCE_FILE, interactive_writer_policy());
+    }
+    sequence_writer.begin_chain();
+    sequence_writer.attach_checkpoint(&state, &predictions_made);
+    if (interactive) {
+        terminal.begin_key_polling();
+    }
+
+    // Rendering runs on its own thread at a fixed rate; this loop only predicts,
+    // writes and publishes.
+    DashboardChannel channel;
+    std::thread dashboard([&channel, interactive]() {
+        if (interactive) {
+            run_dashboard(channel);
+        } else {
+            run_scripted_control(channel);
+        }
+    });
+
+    if (!console_cache_dir.empty() && !segment_cache.is_open()) {
+        segment_cache.open(console_cache_dir, DEFAULT_SEGMENT_CACHE_MEMORY_BYTES, console_cache_disk_bytes);
+    }
+    SegmentCursor cursor(segment_cache.is_open() ? &segment_cache : nullptr, REPLAY_METRICS_EVERY);
+    DashboardSnapshot snapshot; // Replayed steps keep showing the last computed metrics
     
-    return {final_gap, next_prime_result};
+    while (is_running && !channel.stop_requested.load(std::memory_order_relaxed)) { 
+        long long gap = cursor.step(state, predictions_made, snapshot.metrics);
+        
+        predictions_made++;
+        sequence_writer.write(state.prime, gap);
+
+        snapshot.predictions = predictions_made;
+        snapshot.writer = sequence_writer.stats();
+        channel.snapshot.publish(snapshot);
+
+        if (channel.candidate_requested.load(std::memory_order_relaxed)) {
+            channel.candidate_requested.store(false, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(channel.candidate_mutex);
+            channel.candidate_text.clear();
+            state.prime.append_decimal(channel.candidate_text);
+            channel.candidate_step = predictions_made;
+        }
+    }
+
+    channel.ui_done.store(true, std::memory_order_release);
+    dashboard.join();
+    terminal.end_key_polling();
+
+    sequence_writer.flush(); // Keep load_last_prime() consistent with what was shown
+    sequence_writer.detach_checkpoint();
+    user_prime_input = state.prime.to_string();
+
+    if (interactive) {
+        gotoXY(0, 35);
+    }
+    std::cout << "\n\n--- Stopping prediction and returning to menu... ---" << std::endl;
+}
+
+
+// ====================================================================
+// --- METRICS HTTP ENDPOINT ---
+// ====================================================================
+// Optional Prometheus scrape target for long headless runs. The server thread
+// only reads the seqlock snapshot the compute loop publishes, so a scrape (or
+// a stuck client) never blocks a prediction. One connection is served at a
+// time over non-blocking sockets with short timeouts.
+
+#ifdef _WIN32
+typedef SOCKET SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+#else
+typedef int SocketHandle;
+const SocketHandle INVALID_SOCKET_HANDLE = -1;
+#endif
+
+#ifdef MSG_NOSIGNAL
+const int SOCKET_SEND_FLAGS = MSG_NOSIGNAL; // A client hanging up must not raise SIGPIPE
+#else
+const int SOCKET_SEND_FLAGS = 0;
+#endif
+
+const int HTTP_POLL_MS = 100;            // Listener wake-up interval (stop latency)
+const int HTTP_CLIENT_TIMEOUT_MS = 2000; // Per read/write on a client connection
+const size_t HTTP_MAX_REQUEST_BYTES = 8192;
+const long long HTTP_PUBLISH_EVERY = 1024; // Headless steps between snapshot publishes
+
+// Thin RAII wrapper over a BSD / Winsock TCP socket.
+class Socket {
+public:
+    Socket() {}
+    explicit Socket(SocketHandle handle) : handle(handle) {}
+    ~Socket() { close(); }
+
+    Socket(Socket&& other) noexcept : handle(other.handle) { other.handle = INVALID_SOCKET_HANDLE; }
+    Socket& operator=(Socket&& other) noexcept {
+        if (this != &other) {
+            close();
+            handle = other.handle;
+            other.handle = INVALID_SOCKET_HANDLE;
+        }
+        return *this;
+    }
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    // Winsock needs one WSAStartup per process; a no-op elsewhere.
+    static bool startup() {
+#ifdef _WIN32
+        static const bool started = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+#else
+        return true;
+#endif
+    }
+
+    bool is_open() const { return handle != INVALID_SOCKET_HANDLE; }
+
+    // Non-blocking IPv4 listener; 'port' 0 picks a free port (see local_port()).
+    bool listen_on(const std::string& address, int port) {
+        close();
+        if (!startup()) return false;
+        sockaddr_in socket_address;
+        std::memset(&socket_address, 0, sizeof(socket_address));
+        socket_address.sin_family = AF_INET;
+        socket_address.sin_port = htons((unsigned short)port);
+        if (inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) != 1) return false;
+
+        handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (!is_open()) return false;
+        int reuse = 1;
+        setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+        if (::bind(handle, (const sockaddr*)&socket_address, sizeof(socket_address)) != 0 ||
+            ::listen(handle, 16) != 0 || !set_non_blocking()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Connects to 'host' (name or IPv4 address) within 'timeout_ms'; the
+    // socket is non-blocking afterwards like an accepted one.
+    bool connect_to(const std::string& host, int port, int timeout_ms) {
+        close();
+        if (!startup()) return false;
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found) != 0 || found == nullptr) return false;
+
+        handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        bool ok = is_open() && set_non_blocking();
+        if (ok && ::connect(handle, found->ai_addr, (int)found->ai_addrlen) != 0) {
+#ifdef _WIN32
+            bool pending = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+            bool pending = errno == EINPROGRESS;
+#endif
+            int error = 0;
+            socklen_t length = sizeof(error);
+            ok = pending && wait(true, timeout_ms) &&
+                 getsockopt(handle, SOL_SOCKET, SO_ERROR, (char*)&error, &length) == 0 && error == 0;
+        }
+        freeaddrinfo(found);
+        if (!ok) close();
+        return ok;
+    }
+
+    int local_port() const {
+        sockaddr_in socket_address;
+        socklen_t length = sizeof(socket_address);
+        if (getsockname(handle, (sockaddr*)&socket_address, &length) != 0) return -1;
+        return ntohs(socket_address.sin_port);
+    }
+
+    // Waits up to 'timeout_ms' for the socket to become readable (or writable).
+    bool wait(bool for_write, int timeout_ms) const {
+#ifdef _WIN32
+        WSAPOLLFD entry = { handle, (SHORT)(for_write ? POLLWRNORM : POLLRDNORM), 0 };
+        return WSAPoll(&entry, 1, timeout_ms) > 0;
+#else
+        pollfd entry = { handle, (short)(for_write ? POLLOUT : POLLIN), 0 };
+        return ::poll(&entry, 1, timeout_ms) > 0;
+#endif
+    }
+
+    // Invalid socket when no connection is pending.
+    Socket accept_client() const {
+        Socket client(::accept(handle, nullptr, nullptr));
+        if (client.is_open() && !client.set_non_blocking()) {
+            client.close();
+        }
+        return client;
+    }
+
+    // Bytes read, 0 on orderly close or timeout, -1 on error.
+    long long receive(char* data, size_t capacity, int timeout_ms) const {
+        if (!wait(false, timeout_ms)) return 0;
+        long long received = (long long)::recv(handle, data, (int)capacity, 0);
+        return received < 0 ? -1 : received;
+    }
+
+    bool send_all(const std::string& data, int timeout_ms) const {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            if (!wait(true, timeout_ms)) return false;
+            long long written = (long long)::send(handle, data.data() + sent, (int)(data.size() - sent), SOCKET_SEND_FLAGS);
+            if (written <= 0) return false;
+            sent += (size_t)written;
+        }
+        return true;
+    }
+
+    void close() {
+        if (!is_open()) return;
+#ifdef _WIN32
+        closesocket(handle);
+#else
+        ::close(handle);
+#endif
+        handle = INVALID_SOCKET_HANDLE;
+    }
+
+private:
+    bool set_non_blocking() const {
+#ifdef _WIN32
+        u_long enabled = 1;
+        return ioctlsocket(handle, FIONBIO, &enabled) == 0;
+#else
+        int flags = fcntl(handle, F_GETFL, 0);
+        return flags >= 0 && fcntl(handle, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    }
+
+    SocketHandle handle = INVALID_SOCKET_HANDLE;
+};
+
+void write_prometheus_metric(std::ostringstream& out, const char* name, const char* type, const char* help, double value) {
+    out << "# HELP " << name << ' ' << help << '\n';
+    out << "# TYPE " << name << ' ' << type << '\n';
+    out << name << ' ' << value << '\n';
+}
+
+class MetricsHttpServer {
+public:
+    ~MetricsHttpServer() { stop(); }
+
+    bool start(const std::string& address, int port, const SeqlockSnapshot<DashboardSnapshot>* source) {
+        stop();
+        if (!listener.listen_on(address, port)) {
+            return false;
+        }
+        snapshot = source;
+        stopping.store(false, std::memory_order_relaxed);
+        worker = std::thread([this]() { serve(); });
+        return true;
+    }
+
+    int port() const { return listener.local_port(); }
+
+    void stop() {
+        if (!worker.joinable()) {
+            return;
+        }
+        stopping.store(true, std::memory_order_relaxed);
+        worker.join();
+        listener.close();
+    }
+
+private:
+    void serve() {
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (!listener.wait(false, HTTP_POLL_MS)) {
+                continue;
+            }
+            Socket client = listener.accept_client();
+            if (client.is_open()) {
+                handle(client);
+            }
+        }
+    }
+
+    void handle(const Socket& client) {
+        std::string request;
+        char chunk[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < HTTP_MAX_REQUEST_BYTES) {
+            long long received = client.receive(chunk, sizeof(chunk), HTTP_CLIENT_TIMEOUT_MS);
+            if (received <= 0) break;
+            request.append(chunk, (size_t)received);
+        }
+
+        std::istringstream line(request.substr(0, request.find("\r\n")));
+        std::string method, target;
+        line >> method >> target;
+
+        std::string status = "200 OK";
+        std::string body;
+        if (method != "GET" && method != "HEAD") {
+            status = "405 Method Not Allowed";
+            body = "Only GET is supported.\n";
+        } else if (target != "/metrics") {
+            status = "404 Not Found";
+            body = "Metrics are served at /metrics.\n";
+        } else {
+            body = render();
+        }
+
+        std::ostringstream response;
+        response << "HTTP/1.0 " << status << "\r\n"
+                 << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n";
+        if (method != "HEAD") { response << body; }
+        client.send_all(response.str(), HTTP_CLIENT_TIMEOUT_MS);
+    }
+
+    // Prometheus text exposition format.
+    std::string render() {
+        DashboardSnapshot latest;
+        snapshot->read(latest);
+
+        // Rates are left to the scraper: rate(lgo_predictions_total[1m]).
+        const PredictionMetrics& metrics = latest.metrics;
+        std::ostringstream out;
+        out << std::setprecision(15);
+        write_prometheus_metric(out, "lgo_predictions_total", "counter", "Predictions made in this chain, including those before a resume.", (double)latest.predictions);
+        write_prometheus_metric(out, "lgo_current_digits", "gauge", "Decimal digits of the current prime.", (double)metrics.current_prime_digits);
+        write_prometheus_metric(out, "lgo_base_gap", "gauge", "Base gap heuristic of the latest step.", (double)metrics.base_gap_out);
+        write_prometheus_metric(out, "lgo_density_correction_g", "gauge", "Density correction G of the latest step.", (double)metrics.density_correction_G);
+        write_prometheus_metric(out, "lgo_correlative_adjustment", "gauge", "PHI correlative term of the latest step.", metrics.correlative_adjustment);
+        write_prometheus_metric(out, "lgo_delta", "gauge", "Ulam/Mod7 delta of the latest step.", (double)metrics.delta_out);
+        write_prometheus_metric(out, "lgo_final_gap", "gauge", "Final gap of the latest step.", (double)metrics.final_gap);
+        write_prometheus_metric(out, "lgo_pnt_gap_ratio", "gauge", "Final gap divided by ln(P) for the latest step.", metrics.pnt_ratio);
+        out << "# HELP lgo_prime_set Mod 12 set of the latest prime (1 for the current set).\n"
+            << "# TYPE lgo_prime_set gauge\n";
+        for (PrimeSet set : { SET_A, SET_B, SET_C, SET_D }) {
+            out << "lgo_prime_set{set=\"" << prime_set_name(set) << "\"} " << (metrics.current_prime_set == set ? 1 : 0) << '\n';
+        }
+        write_prometheus_metric(out, "lgo_writer_pending_records", "gauge", "Records buffered by the sequence writer.", (double)latest.writer.pending_records);
+        write_prometheus_metric(out, "lgo_writer_pending_bytes", "gauge", "Bytes buffered by the sequence writer.", (double)latest.writer.pending_bytes);
+        write_prometheus_metric(out, "lgo_writer_flushes_total", "counter", "Sequence writer flushes.", (double)latest.writer.flushes);
+        write_prometheus_metric(out, "lgo_writer_last_flush_seconds", "gauge", "Duration of the most recent sequence writer flush.", latest.writer.last_flush_seconds);
+        return out.str();
+    }
+
+    Socket listener;
+    std::thread worker;
+    std::atomic<bool> stopping{ false };
+    const SeqlockSnapshot<DashboardSnapshot>* snapshot = nullptr;
+};
+
+
+// ====================================================================
+// --- WORK-STEALING THREAD POOL ---
+// ====================================================================
+// One deque per worker. Owners push and pop at the back (newest first, cache
+// warm); idle workers steal from the front of the other deques (oldest first),
+// so uneven task sizes still keep every core busy.
+
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned thread_count) {
+        if (thread_count == 0) { thread_count = 1; }
+        for (unsigned i = 0; i < thread_count; i++) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (unsigned i = 0; i < thread_count; i++) {
+            workers.emplace_back([this, i]() { worker_main(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        wait_idle();
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        work_available.notify_all();
+        for (std::thread& worker : workers) { worker.join(); }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // Tasks submitted from a worker go to its own deque, others are spread round-robin.
+    void submit(std::function<void()> task) {
+        unsigned target = (current_worker >= 0 && current_pool == this)
+            ? (unsigned)current_worker
+            : next_queue.fetch_add(1, std::memory_order_relaxed) % (unsigned)queues.size();
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            queued++;
+        }
+        work_available.notify_one();
+    }
+
+    // Blocks until every submitted task has finished.
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        all_done.wait(lock, [this]() { return pending.load(std::memory_order_acquire) == 0; });
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool pop_local(unsigned index, std::function<void()>& task) {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        if (queues[index]->tasks.empty()) return false;
+        task = std::move(queues[index]->tasks.back());
+        queues[index]->tasks.pop_back();
+        return true;
+    }
+
+    bool steal(unsigned thief, std::function<void()>& task) {
+        for (size_t offset = 1; offset < queues.size(); offset++) {
+            WorkerQueue& victim = *queues[(thief + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.tasks.empty()) continue;
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void worker_main(unsigned index) {
+        current_worker = (int)index;
+        current_pool = this;
+        std::function<void()> task;
+
+        while (true) {
+            if (pop_local(index, task) || steal(index, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                    queued--;
+                }
+                task();
+                task = nullptr;
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(sleep_mutex);
+                    all_done.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            work_available.wait(lock, [this]() { return stopping || queued > 0; });
+            if (stopping && queued == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<long long> pending{0};
+    std::atomic<unsigned> next_queue{0};
+
+    std::mutex sleep_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    long long queued = 0; // Tasks sitting in some deque (guarded by sleep_mutex)
+    bool stopping = false;
+
+    static thread_local int current_worker;
+    static thread_local WorkStealingPool* current_pool;
+};
+
+thread_local int WorkStealingPool::current_worker = -1;
+thread_local WorkStealingPool* WorkStealingPool::current_pool = nullptr;
+
+unsigned default_thread_count() {
+    unsigned count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+
+// ====================================================================
+// --- PRIMALITY TESTING (BINARY BIGINT, MILLER-RABIN) ---
+// ====================================================================
+// Decimal limbs are right for printing and digit counts but not for modular
+// arithmetic, so verification converts candidates to a base-2^32 integer and
+// runs Miller-Rabin with Montgomery multiplication (32-bit limbs, 64-bit
+// accumulators: portable, no 128-bit type needed).
+
+class BigUInt {
+public:
+    BigUInt() : limbs(1, 0) {}
+
+    static BigUInt from_decimal(const BigInt& value) {
+        BigUInt result;
+        for (size_t i = value.limb_count(); i-- > 0;) {
+            unsigned long long limb = value.limb(i);
+            result.multiply_add(1000000000U, (unsigned int)(limb / 1000000000ULL));
+            result.multiply_add(1000000000U, (unsigned int)(limb % 1000000000ULL));
+        }
+        return result;
+    }
+
+    size_t limb_count() const { return limbs.size(); }
+    unsigned int limb(size_t index) const { return index < limbs.size() ? limbs[index] : 0; }
+    bool is_even() const { return (limbs[0] & 1) == 0; }
+    bool fits_u32() const { return limbs.size() == 1; }
+
+    size_t bit_length() const {
+        size_t bits = (limbs.size() - 1) * 32;
+        for (unsigned int top = limbs.back(); top != 0; top >>= 1) { bits++; }
+        return bits;
+    }
+
+    bool bit(size_t index) const { return (limb(index / 32) >> (index % 32)) & 1; }
+
+    unsigned int mod_small(unsigned int modulus) const {
+        unsigned long long remainder = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            remainder = ((remainder << 32) | limbs[i]) % modulus;
+        }
+        return (unsigned int)remainder;
+    }
+
+    void multiply_add(unsigned int multiplier, unsigned int addend) {
+        unsigned long long carry = addend;
+        for (unsigned int& limb : limbs) {
+            unsigned long long product = (unsigned long long)limb * multiplier + carry;
+            limb = (unsigned int)product;
+            carry = product >> 32;
+        }
+        if (carry != 0) { limbs.push_back((unsigned int)carry); }
+        trim();
+    }
+
+    void add_small(unsigned int value) { multiply_add(1, value); }
+
+    // this -= value, for this >= value.
+    void subtract_small(unsigned int value) {
+        unsigned long long borrow = value;
+        for (size_t i = 0; i < limbs.size() && borrow != 0; i++) {
+            unsigned long long current = limbs[i];
+            limbs[i] = (unsigned int)(current - borrow);
+            borrow = (current < borrow) ? 1 : 0;
+        }
+        trim();
+    }
+
+    void shift_right(size_t bits) {
+        size_t limb_shift = bits / 32;
+        int bit_shift = (int)(bits % 32);
+        if (limb_shift >= limbs.size()) { limbs.assign(1, 0); return; }
+        limbs.erase(limbs.begin(), limbs.begin() + (std::ptrdiff_t)limb_shift);
+        if (bit_shift != 0) {
+            for (size_t i = 0; i < limbs.size(); i++) {
+                unsigned long long next = (i + 1 < limbs.size()) ? limbs[i + 1] : 0;
+                limbs[i] = (unsigned int)((limbs[i] >> bit_shift) | (next << (32 - bit_shift)));
+            }
+        }
+        trim();
+    }
+
+    // Raw limbs, least significant first.
+    const std::vector<unsigned int>& limb_data() const { return limbs; }
+
+private:
+    void trim() {
+        while (limbs.size() > 1 && limbs.back() == 0) { limbs.pop_back(); }
+    }
+
+    std::vector<unsigned int> limbs;
+};
+
+// Arithmetic modulo an odd n in Montgomery form (R = 2^(32k), k limbs of n).
+class MontgomeryContext {
+public:
+    explicit MontgomeryContext(const BigUInt& modulus) : n(modulus.limb_data()), k(modulus.limb_count()) {
+        // -n^-1 mod 2^32 by Newton iteration (n is odd).
+        unsigned int inverse = 1;
+        for (int i = 0; i < 5; i++) { inverse *= 2 - n[0] * inverse; }
+        n_prime = 0U - inverse;
+
+        // R mod n and R^2 mod n by repeated doubling.
+        one.assign(k, 0);
+        one[0] = 1;
+        for (size_t i = 0; i < 32 * k; i++) { double_mod(one); }
+        r_squared = one;
+        for (size_t i = 0; i < 32 * k; i++) { double_mod(r_squared); }
+        scratch.assign(k + 2, 0);
+    }
+
+    size_t limb_count() const { return k; }
+    const std::vector<unsigned int>& one_value() const { return one; }
+
+    // n - 1 in Montgomery form (n - R mod n).
+    std::vector<unsigned int> minus_one_value() const {
+        std::vector<unsigned int> result(k, 0);
+        unsigned long long borrow = 0;
+        for (size_t i = 0; i < k; i++) {
+            unsigned long long difference = (unsigned long long)n[i] - one[i] - borrow;
+            result[i] = (unsigned int)difference;
+            borrow = (difference >> 63) & 1;
+        }
+        return result;
+    }
+
+    std::vector<unsigned int> to_montgomery(unsigned int value) {
+        std::vector<unsigned int> plain(k, 0);
+        plain[0] = value;
+        std::vector<unsigned int> result(k, 0);
+        multiply(plain, r_squared, result);
+        return result;
+    }
+
+    // result = a * b * R^-1 mod n (CIOS). 'result' may alias 'a' or 'b'.
+    void multiply(const std::vector<unsigned int>& a, const std::vector<unsigned int>& b, std::vector<unsigned int>& result) {
+        std::fill(scratch.begin(), scratch.end(), 0);
+        unsigned int* t = scratch.data();
+        for (size_t i = 0; i < k; i++) {
+            unsigned long long carry = 0;
+            unsigned long long b_i = b[i];
+            for (size_t j = 0; j < k; j++) {
+                unsigned long long sum = (unsigned long long)t[j] + (unsigned long long)a[j] * b_i + carry;
+                t[j] = (unsigned int)sum;
+                carry = sum >> 32;
+            }
+            unsigned long long sum = (unsigned long long)t[k] + carry;
+            t[k] = (unsigned int)sum;
+            t[k + 1] = (unsigned int)(sum >> 32);
+
+            unsigned long long m = (unsigned int)(t[0] * n_prime);
+            sum = (unsigned long long)t[0] + m * n[0];
+            carry = sum >> 32;
+            for (size_t j = 1; j < k; j++) {
+                sum = (unsigned long long)t[j] + m * n[j] + carry;
+                t[j - 1] = (unsigned int)sum;
+                carry = sum >> 32;
+            }
+            sum = (unsigned long long)t[k] + carry;
+            t[k - 1] = (unsigned int)sum;
+            t[k] = t[k + 1] + (unsigned int)(sum >> 32);
+        }
+        if (t[k] != 0 || !less_than_modulus(t)) {
+            subtract_modulus(t);
+        }
+        std::copy(t, t + k, result.begin());
+    }
+
+private:
+    bool less_than_modulus(const unsigned int* value) const {
+        for (size_t i = k; i-- > 0;) {
+            if (value[i] != n[i]) return value[i] < n[i];
+        }
+        return false;
+    }
+
+    void subtract_modulus(unsigned int* value) const {
+        unsigned long long borrow = 0;
+        for (size_t i = 0; i < k; i++) {
+            unsigned long long difference = (unsigned long long)value[i] - n[i] - borrow;
+            value[i] = (unsigned int)difference;
+            borrow = (difference >> 63) & 1;
+        }
+    }
+
+    // value = 2 * value mod n, for value < n.
+    void double_mod(std::vector<unsigned int>& value) const {
+        unsigned int carry = 0;
+        for (size_t i = 0; i < k; i++) {
+            unsigned int next = value[i] >> 31;
+            value[i] = (value[i] << 1) | carry;
+            carry = next;
+        }
+        if (carry != 0 || !less_than_modulus(value.data())) {
+            std::vector<unsigned int> copy = value;
+            subtract_modulus(copy.data());
+            value = copy;
+        }
+    }
+
+    std::vector<unsigned int> n;
+    size_t k;
+    unsigned int n_prime = 0;
+    std::vector<unsigned int> one;
+    std::vector<unsigned int> r_squared;
+    std::vector<unsigned int> scratch;
+};
+
+const unsigned int TRIAL_DIVISION_LIMIT = 2000;
+
+// Primes below TRIAL_DIVISION_LIMIT (simple sieve, built once).
+const std::vector<unsigned int>& small_primes() {
+    static const std::vector<unsigned int> primes = []() {
+        std::vector<unsigned int> result;
+        std::vector<bool> composite(TRIAL_DIVISION_LIMIT, false);
+        for (unsigned int i = 2; i < TRIAL_DIVISION_LIMIT; i++) {
+            if (composite[i]) continue;
+            result.push_back(i);
+            for (unsigned int j = i * i; j < TRIAL_DIVISION_LIMIT; j += i) { composite[j] = true; }
+        }
+        return result;
+    }();
+    return primes;
+}
+
+// The first 13 prime bases make Miller-Rabin deterministic below 3.3 * 10^24
+// (every 10-19 digit PRIME_LIST chain). Above that it is a probable-prime test
+// with these 20 fixed bases and no proven error bound: the 4^-20 bound only
+// holds for random bases, and composites passing every one of these exist.
+const unsigned int MILLER_RABIN_BASES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71};
+const size_t MILLER_RABIN_DETERMINISTIC_BASES = 13;
+const size_t MILLER_RABIN_DETERMINISTIC_BITS = 81; // 3.3 * 10^24 > 2^81
+
+bool miller_rabin(const BigUInt& n) {
+    BigUInt d = n;
+    d.subtract_small(1);
+    size_t s = 0;
+    while (d.is_even()) { d.shift_right(1); s++; }
+
+    MontgomeryContext context(n);
+    const std::vector<unsigned int> one = context.one_value();
+    const std::vector<unsigned int> minus_one = context.minus_one_value();
+    std::vector<unsigned int> x(context.limb_count(), 0);
+
+    size_t base_count = (n.bit_length() <= MILLER_RABIN_DETERMINISTIC_BITS)
+        ? MILLER_RABIN_DETERMINISTIC_BASES
+        : sizeof(MILLER_RABIN_BASES) / sizeof(MILLER_RABIN_BASES[0]);
+
+    for (size_t b = 0; b < base_count; b++) {
+        std::vector<unsigned int> base = context.to_montgomery(MILLER_RABIN_BASES[b]);
+
+        // x = base^d (left-to-right binary exponentiation)
+        x = one;
+        for (size_t bit = d.bit_length(); bit-- > 0;) {
+            context.multiply(x, x, x);
+            if (d.bit(bit)) { context.multiply(x, base, x); }
+        }
+        if (x == one || x == minus_one) continue;
+
+        bool witness = true;
+        for (size_t r = 1; r < s; r++) {
+            context.multiply(x, x, x);
+            if (x == minus_one) { witness = false; break; }
+            if (x == one) break;
+        }
+        if (witness) return false;
+    }
+    return true;
+}
+
+bool is_probable_prime(const BigUInt& n) {
+    if (n.fits_u32() && n.limb(0) < 2) return false;
+    for (unsigned int p : small_primes()) {
+        if (n.fits_u32() && n.limb(0) == p) return true;
+        if (n.mod_small(p) == 0) return false;
+    }
+    if (n.fits_u32() && (unsigned long long)n.limb(0) < (unsigned long long)TRIAL_DIVISION_LIMIT * TRIAL_DIVISION_LIMIT) {
+        return true;
+    }
+    return miller_rabin(n);
+}
+
+// Distance from 'value' to the smallest prime >= value. Offsets are sieved by
+// the small primes using residues of 'value' taken once, so only survivors pay
+// for a Miller-Rabin test.
+unsigned long long next_prime_distance(const BigInt& value) {
+    BigUInt start = BigUInt::from_decimal(value);
+    if (start.fits_u32() && start.limb(0) <= 2) {
+        return 2 - start.limb(0);
+    }
+
+    const std::vector<unsigned int>& primes = small_primes();
+    std::vector<unsigned int> residues(primes.size());
+    for (size_t i = 0; i < primes.size(); i++) { residues[i] = start.mod_small(primes[i]); }
+    bool small_value = start.fits_u32() && (unsigned long long)start.limb(0) < (unsigned long long)TRIAL_DIVISION_LIMIT * TRIAL_DIVISION_LIMIT;
+
+    BigUInt candidate = start;
+    unsigned long long offset = 0;
+    if (start.is_even()) {
+        candidate.add_small(1);
+        offset = 1;
+    }
+    while (true) {
+        bool survives = true;
+        if (!small_value) {
+            for (size_t i = 0; i < primes.size(); i++) {
+                if ((residues[i] + offset) % primes[i] == 0) { survives = false; break; }
+            }
+        }
+        if (survives && is_probable_prime(candidate)) {
+            return offset;
+        }
+        candidate.add_small(2);
+        offset += 2;
+    }
+}
+
+
+// ====================================================================
+// --- CANDIDATE VERIFICATION PIPELINE ---
+// ====================================================================
+// Optional stage: each candidate is copied into a task and tested on a worker
+// pool while the generator keeps going. Results are written in step order
+// (a small reorder buffer absorbs out-of-order completion), one line per record:
+//   step,candidate,is_prime,next_prime_distance
+// The generator only waits when the unverified records hold max_in_flight_bytes,
+// which bounds memory when verification is slower than generation. A record is
+// charged for its task copy, its decimal text and a fixed per-record overhead,
+// so the bound holds for 10-digit and 100,000-digit chains alike.
+
+const size_t VERIFY_MAX_IN_FLIGHT_BYTES = 64 << 20;
+const size_t VERIFY_RECORD_OVERHEAD_BYTES = 128; // Task, reorder-buffer node and result
+
+size_t verify_record_bytes(const BigInt& candidate) {
+    return candidate.limb_count() * sizeof(unsigned long long) + (size_t)candidate.digit_count() + VERIFY_RECORD_OVERHEAD_BYTES;
+}
+
+struct VerificationResult {
+    bool is_prime = false;
+    unsigned long long next_prime_distance = 0; // 0 when the candidate is prime
+    std::string candidate = "";
+};
+
+VerificationResult verify_candidate(const BigInt& candidate) {
+    VerificationResult result;
+    result.next_prime_distance = next_prime_distance(candidate);
+    result.is_prime = (result.next_prime_distance == 0);
+    result.candidate = candidate.to_string();
+    return result;
+}
+
+class CandidateVerifier {
+public:
+    ~CandidateVerifier() { close(); }
+
+    bool open(const std::string& path, unsigned threads, size_t in_flight_limit_bytes) {
+        out.open(path, std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out << "step,candidate,is_prime,next_prime_distance\n";
+        max_in_flight_bytes = std::max<size_t>(1, in_flight_limit_bytes);
+        pool.reset(new WorkStealingPool(threads));
+        return true;
+    }
+
+    bool is_open() const { return pool != nullptr; }
+
+    // A record larger than the whole budget is still admitted once nothing else is in flight.
+    void submit(long long step, const BigInt& candidate) {
+        size_t bytes = verify_record_bytes(candidate);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            space_available.wait(lock, [this, bytes]() { return in_flight_bytes == 0 || in_flight_bytes + bytes <= max_in_flight_bytes; });
+            in_flight_bytes += bytes;
+            if (next_step < 0) { next_step = step; }
+        }
+        pool->submit([this, step, candidate, bytes]() {
+            VerificationResult result = verify_candidate(candidate);
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.emplace(step, PendingResult{ std::move(result), bytes });
+            drain_in_order();
+        });
+    }
+
+    // Waits for every submitted record; their results are written by then.
+    void close() {
+        if (pool == nullptr) {
+            return;
+        }
+        pool->wait_idle();
+        pool.reset();
+        out.close();
+    }
+
+    long long verified_count() const { return verified; }
+    long long prime_count() const { return primes; }
+
+private:
+    struct PendingResult {
+        VerificationResult result;
+        size_t bytes = 0; // Charged against max_in_flight_bytes until written
+    };
+
+    // Caller holds 'mutex'.
+    void drain_in_order() {
+        while (!completed.empty() && completed.begin()->first == next_step) {
+            write_result(completed.begin()->first, completed.begin()->second.result);
+            in_flight_bytes -= completed.begin()->second.bytes;
+            completed.erase(completed.begin());
+            next_step++;
+            space_available.notify_one();
+        }
+    }
+
+    void write_result(long long step, const VerificationResult& result) {
+        out << step << ',' << result.candidate << ',' << (result.is_prime ? "prime" : "composite") << ',' << result.next_prime_distance << '\n';
+        verified++;
+        if (result.is_prime) { primes++; }
+    }
+
+    std::unique_ptr<WorkStealingPool> pool;
+    std::ofstream out;
+    std::mutex mutex;
+    std::condition_variable space_available;
+    std::map<long long, PendingResult> completed;
+    size_t max_in_flight_bytes = 1;
+    size_t in_flight_bytes = 0;
+    long long next_step = -1;
+    long long verified = 0;
+    long long primes = 0;
+};
+
+
+// ====================================================================
+// --- PIPELINED CHAIN OUTPUT ---
+// ====================================================================
+// generator -> serializer -> writer. The generator (the caller's thread) only
+// predicts and pushes each gap into a bounded SPSC ring. The serializer thread
+// replays the gaps onto its own copy of the state, renders the records through
+// a SequenceWriter and hands full buffers to the AsyncFileWriter thread. Full
+// rings block the stage before them, so memory stays bounded when the disk is
+// slower than the model. Resume checkpoints are taken from the serializer's
+// copy, which always matches the last record it rendered.
+
+const size_t PIPELINE_GAP_RING = 1 << 16; // Gaps in flight between generator and serializer
+
+class ChainPipeline {
+public:
+    ChainPipeline() : gaps(PIPELINE_GAP_RING) {}
+    ~ChainPipeline() { close(); }
+
+    // 'start' is the state before the first pushed gap and 'predictions_before'
+    // the prediction counter at that point.
+    bool open(const std::string& path, const SequenceWriterPolicy& policy, const PredictionState& start, long long predictions_before) {
+        SequenceWriterPolicy async_policy = policy;
+        async_policy.async_io = true;
+        mirror = start;
+        mirror_predictions = predictions_before;
+        written_ok = true;
+        if (!writer.open(path, async_policy, &mirror.prime)) {
+            return false;
+        }
+        writer.attach_checkpoint(&mirror, &mirror_predictions);
+        backend = writer.io_backend();
+        serializer = std::thread([this]() { serialize(); });
+        return true;
+    }
+
+    bool is_open() const { return serializer.joinable(); }
+
+    // Generator side; waits while the ring is full.
+    void push(long long gap) {
+        gaps.acquire_push() = gap;
+        gaps.commit_push();
+    }
+
+    // Drains every stage and closes the file (with a final checkpoint); false
+    // when any write failed.
+    bool close() {
+        if (serializer.joinable()) {
+            gaps.close();
+            serializer.join();
+        }
+        return written_ok;
+    }
+
+    // Safe from the generator thread while the pipeline runs.
+    SequenceWriterStats stats() const {
+        SequenceWriterStats current;
+        current.pending_records = (long long)gaps.depth();
+        current.pending_bytes = pending_bytes.load(std::memory_order_relaxed);
+        current.flushes = flushes.load(std::memory_order_relaxed);
+        current.last_flush_seconds = last_flush_seconds.load(std::memory_order_relaxed);
+        return current;
+    }
+
+    std::string io_backend() const { return backend; }
+
+private:
+    void serialize() {
+        unsigned long long rendered = 0;
+        while (long long* gap = gaps.front()) {
+            mirror.advance(*gap);
+            mirror_predictions++;
+            writer.write(mirror.prime, *gap);
+            gaps.pop();
+            if ((++rendered & 1023) == 0) { publish_stats(); }
+        }
+        written_ok = writer.close();
+        publish_stats();
+    }
+
+    void publish_stats() {
+        SequenceWriterStats current = writer.stats();
+        pending_bytes.store(current.pending_bytes, std::memory_order_relaxed);
+        flushes.store(current.flushes, std::memory_order_relaxed);
+        last_flush_seconds.store(current.last_flush_seconds, std::memory_order_relaxed);
+    }
+
+    SpscRing<long long> gaps;
+    PredictionState mirror;          // Serializer only
+    long long mirror_predictions = 0; // Serializer only
+    SequenceWriter writer;           // Serializer only
+    std::thread serializer;
+    bool written_ok = true;          // Set by the serializer before it exits
+    std::string backend = "";
+    std::atomic<long long> pending_bytes{ 0 };
+    std::atomic<long long> flushes{ 0 };
+    std::atomic<double> last_flush_seconds{ 0.0 };
+};
+
+
+// ====================================================================
+// --- HEADLESS BATCH ENGINE ---
+// ====================================================================
+
+struct HeadlessOptions {
+    std::string start_prime = "";
+    long long count = 0;
+    std::string out_file = SEQUENCE_FILE;
+    SequenceWriterPolicy writer_policy;
+    bool resume = false;
+    std::string chains_source = ""; // Seed file or "builtin" (PRIME_LIST); enables the multi-chain runner
+    std::string out_dir = "lgo_chains";
+    unsigned threads = 0;           // 0 = all hardware threads
+    bool verify = false;            // Miller-Rabin annotation of every candidate
+    std::string verify_out = "";    // Default: <out>.verify.csv
+    bool ground_truth = false;      // Compare predicted gaps against a sieve instead of writing a sequence
+    std::string metrics_file = "";  // Per-step PredictionMetrics stream (empty = off)
+    MetricsFormat metrics_format = METRICS_CSV;
+    int pipeline = -1;              // Background render/write stages: 1 on, 0 off, -1 when there is more than one hardware thread
+    int http_port = -1;             // Prometheus endpoint port (-1 = off, 0 = any free port)
+    std::string http_bind = "127.0.0.1";
+    std::string cache_dir = "";     // Segment cache directory (empty = off)
+    long long cache_disk_bytes = DEFAULT_SEGMENT_CACHE_DISK_BYTES;
+    int shard_port = -1;            // Coordinator listen port (-1 = not sharded, 0 = any free port)
+    std::string shard_bind = "127.0.0.1";
+    long long shard_steps = 1LL << 20;
+    std::string sweep_source = "";  // Variant file or "grid"; enables the parameter sweep
+    std::string sweep_phi = "";     // Grid values for phi_dampener (<from>:<to>:<count>)
+    std::string sweep_divisor = ""; // Grid values for the base-gap divisor
+};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [--start <prime> --count <N> [--out <file>]]" << std::endl;
+    std::cout << "  (no arguments)     Interactive console mode (--cache <dir> [--cache-mb <N>] alone: with a segment cache)" << std::endl;
+    std::cout << "  --profile          Time the model stages and sequence writes (any mode; summary on exit)" << std::endl;
+    std::cout << "  --start <prime>    Starting prime (digits only, arbitrary length)" << std::endl;
+    std::cout << "  --count <N>        Number of predictions to run" << std::endl;
+    std::cout << "  --out <file>       Output sequence file (default: " << SEQUENCE_FILE << ")" << std::endl;
+    std::cout << "  --resume           Continue from the checkpoint / last record of --out instead of --start" << std::endl;
+    std::cout << "  --verify           Miller-Rabin check of every candidate on worker threads (--threads)" << std::endl;
+    std::cout << "  --verify-out <f>   Verification CSV (default: <out>.verify.csv)" << std::endl;
+    std::cout << "  --metrics <file>   Also stream every step's PredictionMetrics (--metrics-format csv|ndjson|bin)" << std::endl;
+    std::cout << "  --http-port <N>    Serve Prometheus metrics at http://<bind>:<N>/metrics during the run" << std::endl;
+    std::cout << "  --http-bind <addr> Listen address for --http-port (default: 127.0.0.1)" << std::endl;
+    std::cout << "  --groundtruth      Predicted vs sieved actual gaps for --count steps (chain below 2^64);" << std::endl;
+    std::cout << "                     per-step CSV to --out (default lgo_groundtruth.csv)" << std::endl;
+    std::cout << "  --format <text|bin> Output format (default: text)" << std::endl;
+    std::cout << "  --keyframe <N>     Records per binary block / keyframe (default: " << BINARY_DEFAULT_KEYFRAME_INTERVAL << ")" << std::endl;
+    std::cout << "  --buffer-kb <N>    Writer buffer size in KiB (default: 1024)" << std::endl;
+    std::cout << "  --flush-records <N> Also flush every N records (default: off)" << std::endl;
+    std::cout << "  --flush-ms <N>     Also flush every N milliseconds (default: off)" << std::endl;
+    std::cout << "  --pipeline / --no-pipeline  Render and write on background stages (default: with 2+ hardware threads)" << std::endl;
+    std::cout << "  --cache <dir>      Replay known chain segments from (and record new ones to) a segment cache" << std::endl;
+    std::cout << "  --cache-mb <N>     Disk cap of the segment cache in MiB (default: " << DEFAULT_SEGMENT_CACHE_DISK_BYTES / (1024 * 1024) << ")" << std::endl;
+    std::cout << "Multi-chain runner (one independent chain per seed, all cores):" << std::endl;
+    std::cout << "  --chains <file|builtin> Seeds, one per line (builtin = the menu's PRIME_LIST)" << std::endl;
+    std::cout << "  --out-dir <dir>    Directory for per-chain outputs, replaced unless --resume (default: lgo_chains)" << std::endl;
+    std::cout << "  --threads <N>      Worker threads (default: all hardware threads)" << std::endl;
+    std::cout << "Parameter sweep (model variants scored against the true gaps after each seed, below 2^64):" << std::endl;
+    std::cout << "  --sweep <file|grid> Variants, one per line: phi=<x> divisor=<x> d12=<5 values> d7=<7 values>" << std::endl;
+    std::cout << "  --sweep-phi <from:to:n> / --sweep-divisor <from:to:n>  Axes of --sweep grid" << std::endl;
+    std::cout << "                     Seeds from --chains (default builtin), --count primes each, CSV to --out (lgo_sweep.csv)" << std::endl;
+    std::cout << "Sharded run (one chain, shards predicted by --worker processes, output as a serial run):" << std::endl;
+    std::cout << "  --coordinate <port> Hand out shards of --start/--resume, --count to workers on this port" << std::endl;
+    std::cout << "  --shard-bind <addr> Listen address for --coordinate (default: 127.0.0.1)" << std::endl;
+    std::cout << "  --shard-steps <N>  Steps per shard (default: 1048576)" << std::endl;
+    std::cout << "  --worker <host:port> Predict shards for a coordinator until it is done" << std::endl;
+    std::cout << "Tools:" << std::endl;
+    std::cout << "  --convert-to-bin <text> <bin> [--keyframe <N>]   Text sequence to binary" << std::endl;
+    std::cout << "  --convert-to-text <bin> <text>                   Binary sequence to text" << std::endl;
+    std::cout << "  --seek <file> <step>                             Print candidate #step (text or binary)" << std::endl;
+    std::cout << "  --stats <file>                                   Set frequencies, gaps and PNT ratios" << std::endl;
+    std::cout << "  --jump <prime> <k>                               Candidate k steps ahead, without the steps between" << std::endl;
+    std::cout << "  --bench [--json <file>] [--max-digits <N>] [--budget-ms <N>]  Per-stage benchmark" << std::endl;
+    std::cout << "  --diff [--steps <N>] [--random <N>] [--max-digits <N>] [--rng-seed <N>]" << std::endl;
+    std::cout << "                     Check the optimised engines against the string reference, with speedups" << std::endl;
+}
+
+bool parse_count_value(const std::string& option, const std::string& value, long long& out) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.length() > 18) {
+        std::cerr << "Invalid " << option << " value: " << value << std::endl;
+        return false;
+    }
+    out = std::stoll(value);
+    return true;
+}
+
+// Returns false (after printing the reason) if the command line is unusable.
+bool parse_headless_options(int argc, char* argv[], HeadlessOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (arg == "--start" && has_value) {
+            options.start_prime = argv[++i];
+        } else if (arg == "--count" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.count)) return false;
+        } else if (arg == "--out" && has_value) {
+            options.out_file = argv[++i];
+        } else if (arg == "--resume") {
+            options.resume = true;
+        } else if (arg == "--pipeline") {
+            options.pipeline = 1;
+        } else if (arg == "--no-pipeline") {
+            options.pipeline = 0;
+        } else if (arg == "--verify") {
+            options.verify = true;
+        } else if (arg == "--groundtruth") {
+            options.ground_truth = true;
+        } else if (arg == "--metrics" && has_value) {
+            options.metrics_file = argv[++i];
+        } else if (arg == "--metrics-format" && has_value) {
+            std::string format = argv[++i];
+            if (!parse_metrics_format(format, options.metrics_format)) {
+                std::cerr << "Unknown --metrics-format: " << format << std::endl;
+                return false;
+            }
+        } else if (arg == "--http-port" && has_value) {
+            long long port = 0;
+            if (!parse_count_value(arg, argv[++i], port) || port > 65535) return false;
+            options.http_port = (int)port;
+        } else if (arg == "--http-bind" && has_value) {
+            options.http_bind = argv[++i];
+        } else if (arg == "--coordinate" && has_value) {
+            long long port = 0;
+            if (!parse_count_value(arg, argv[++i], port) || port > 65535) return false;
+            options.shard_port = (int)port;
+        } else if (arg == "--shard-bind" && has_value) {
+            options.shard_bind = argv[++i];
+        } else if (arg == "--shard-steps" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.shard_steps) || options.shard_steps <= 0) return false;
+        } else if (arg == "--sweep" && has_value) {
+            options.sweep_source = argv[++i];
+        } else if (arg == "--sweep-phi" && has_value) {
+            options.sweep_phi = argv[++i];
+        } else if (arg == "--sweep-divisor" && has_value) {
+            options.sweep_divisor = argv[++i];
+        } else if (arg == "--cache" && has_value) {
+            options.cache_dir = argv[++i];
+        } else if (arg == "--cache-mb" && has_value) {
+            long long mib = 0;
+            if (!parse_count_value(arg, argv[++i], mib) || mib <= 0 || mib > 1024LL * 1024 * 1024) return false;
+            options.cache_disk_bytes = mib * 1024 * 1024;
+        } else if (arg == "--verify-out" && has_value) {
+            options.verify = true;
+            options.verify_out = argv[++i];
+        } else if (arg == "--chains" && has_value) {
+            options.chains_source = argv[++i];
+        } else if (arg == "--out-dir" && has_value) {
+            options.out_dir = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            long long threads = 0;
+            if (!parse_count_value(arg, argv[++i], threads) || threads <= 0 || threads > 4096) return false;
+            options.threads = (unsigned)threads;
+        } else if (arg == "--format" && has_value) {
+            std::string format = argv[++i];
+            if (format == "text") {
+                options.writer_policy.format = SEQUENCE_TEXT;
+            } else if (format == "bin") {
+                options.writer_policy.format = SEQUENCE_BINARY;
+            } else {
+                std::cerr << "Unknown --format: " << format << std::endl;
+                return false;
+            }
+        } else if (arg == "--keyframe" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.writer_policy.keyframe_interval) || options.writer_policy.keyframe_interval <= 0) return false;
+        } else if (arg == "--buffer-kb" && has_value) {
+            long long kib = 0;
+            if (!parse_count_value(arg, argv[++i], kib) || kib <= 0) return false;
+            options.writer_policy.buffer_bytes = (size_t)kib * 1024;
+        } else if (arg == "--flush-records" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.writer_policy.flush_every_records)) return false;
+        } else if (arg == "--flush-ms" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.writer_policy.flush_every_ms)) return false;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.chains_source.empty() && options.sweep_source.empty() && !options.resume && (options.start_prime.empty() || options.start_prime.find_first_not_of("0123456789") != std::string::npos)) {
+        std::cerr << "--start requires a prime made of digits only." << std::endl;
+        return false;
+    }
+    if (options.count <= 0) {
+        std::cerr << "--count must be a positive integer." << std::endl;
+        return false;
+    }
+    if (options.resume && !options.start_prime.empty()) {
+        std::cerr << "--resume continues from --out; it cannot be combined with --start." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// True when the command line only holds console options (--cache, --cache-mb),
+// which are then applied to the interactive session.
+bool parse_console_options(int argc, char* argv[]) {
+    std::string cache_dir = "";
+    long long disk_bytes = DEFAULT_SEGMENT_CACHE_DISK_BYTES;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        long long mib = 0;
+        if (arg == "--cache" && has_value) {
+            cache_dir = argv[++i];
+        } else if (arg == "--cache-mb" && has_value && parse_count_value(arg, argv[i + 1], mib) && mib > 0 && mib <= 1024LL * 1024 * 1024) {
+            disk_bytes = mib * 1024 * 1024;
+            i++;
+        } else {
+            return false;
+        }
+    }
+    if (cache_dir.empty()) {
+        return false;
+    }
+    console_cache_dir = cache_dir;
+    console_cache_disk_bytes = disk_bytes;
+    return true;
+}
+
+// --start, or with --resume the checkpoint / last record of --out (which also
+// restores the prediction counter).
+bool load_start_state(const HeadlessOptions& options, PredictionState& state) {
+    if (options.resume) {
+        SequenceCheckpoint resume;
+        if (!load_resume_point(options.out_file, resume)) {
+            std::cerr << "Nothing to resume in: " << options.out_file << std::endl;
+            return false;
+        }
+        restore_state(state, resume);
+        predictions_made = resume.predictions_made;
+    } else {
+        state.reset(BigInt(options.start_prime));
+    }
+    return true;
+}
+
+// Runs the same deterministic chain as prediction_loop(), without the console UI or the pause.
+int run_headless(const HeadlessOptions& options) {
+    PredictionState state;
+    if (!load_start_state(options, state)) {
+        return 1;
+    }
+
+    // On a single hardware thread the extra stages only add context switches.
+    bool pipelined = options.pipeline == 1 || (options.pipeline < 0 && std::thread::hardware_concurrency() > 1);
+    ChainPipeline pipeline;
+    SequenceWriter writer;
+    bool opened = pipelined ? pipeline.open(options.out_file, options.writer_policy, state, predictions_made)
+                                   : writer.open(options.out_file, options.writer_policy, &state.prime);
+    if (!opened) {
+        std::cerr << "Could not open output file (or it is in the other format): " << options.out_file << std::endl;
+        return 1;
+    }
+    if (!pipelined) {
+        writer.attach_checkpoint(&state, &predictions_made);
+    }
+
+    CandidateVerifier verifier;
+    std::string verify_path = options.verify_out.empty() ? options.out_file + ".verify.csv" : options.verify_out;
+    if (options.verify && !verifier.open(verify_path, options.threads != 0 ? options.threads : default_thread_count(), VERIFY_MAX_IN_FLIGHT_BYTES)) {
+        std::cerr << "Could not open verification output: " << verify_path << std::endl;
+        return 1;
+    }
+
+    MetricsSink metrics_sink;
+    if (!options.metrics_file.empty() && !metrics_sink.open(options.metrics_file, options.metrics_format)) {
+        std::cerr << "Could not open metrics output: " << options.metrics_file << std::endl;
+        return 1;
+    }
+
+    // Replayed steps have no metrics, so a metrics stream always predicts.
+    SegmentCache cache;
+    if (!options.cache_dir.empty()) {
+        if (!options.metrics_file.empty()) {
+            std::cerr << "--metrics needs every step's metrics; the segment cache is not used." << std::endl;
+        } else if (!cache.open(options.cache_dir, DEFAULT_SEGMENT_CACHE_MEMORY_BYTES, options.cache_disk_bytes)) {
+            std::cerr << "Could not open segment cache: " << options.cache_dir << std::endl;
+            return 1;
+        }
+    }
+    SegmentCursor cursor(cache.is_open() ? &cache : nullptr, REPLAY_METRICS_EVERY);
+
+    long long predictions_at_start = predictions_made;
+    PredictionMetrics metrics;
+
+    // Published every HTTP_PUBLISH_EVERY steps for the metrics endpoint.
+    SeqlockSnapshot<DashboardSnapshot> snapshot;
+    DashboardSnapshot published;
+    published.predictions = predictions_made;
+    snapshot.publish(published);
+    MetricsHttpServer http_server;
+    if (options.http_port >= 0) {
+        if (!http_server.start(options.http_bind, options.http_port, &snapshot)) {
+            std::cerr << "Could not listen on " << options.http_bind << ":" << options.http_port << std::endl;
+            return 1;
+        }
+        std::cout << "Metrics endpoint: http://" << options.http_bind << ":" << http_server.port() << "/metrics" << std::endl;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    for (long long step = 0; step < options.count; step++) {
+        long long gap = cursor.step(state, predictions_made, metrics);
+        predictions_made++;
+        if (pipelined) {
+            pipeline.push(gap);
+        } else {
+            writer.write(state.prime, gap);
+        }
+        if (metrics_sink.is_open()) { metrics_sink.append(predictions_made, metrics); }
+        if (options.verify) { verifier.submit(predictions_made, state.prime); }
+        if (options.http_port >= 0 && (step % HTTP_PUBLISH_EVERY == 0 || step + 1 == options.count)) {
+            published.metrics = metrics;
+            published.predictions = predictions_made;
+            published.writer = pipelined ? pipeline.stats() : writer.stats();
+            snapshot.publish(published);
+        }
+    }
+    bool written = pipeline.close() && writer.close();
+    bool metrics_written = metrics_sink.close();
+    verifier.close();
+    http_server.stop();
+
+    auto end_time = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    long long steps_run = predictions_made - predictions_at_start;
+    double steps_per_sec = (seconds > 0.0) ? (double)steps_run / seconds : 0.0;
+
+    std::cout << "--- Headless Run Complete ---" << std::endl;
+    std::cout << "Predictions This Run: " << steps_run << std::endl;
+    std::cout << "Total Predictions: " << predictions_made << std::endl;
+    std::cout << "Final Candidate Digits: " << state.digits() << std::endl;
+    std::cout << "Elapsed (s): " << std::fixed << std::setprecision(3) << seconds << std::endl;
+    std::cout << "Throughput (predictions/s): " << std::fixed << std::setprecision(1) << steps_per_sec << std::endl;
+    std::cout << "Output: " << options.out_file << std::endl;
+    if (pipelined) {
+        std::cout << "Writer: pipelined (" << pipeline.io_backend() << ")" << std::endl;
+    }
+    if (cache.is_open()) {
+        SegmentCacheStats cache_stats = cache.stats();
+        std::cout << "Segment Cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses, "
+                  << cache_stats.stored << " stored, " << cache_stats.evicted << " evicted (" << cache.path() << ")" << std::endl;
+    }
+    if (density_fallbacks.load() > 0) {
+        std::cout << "Density Rounding: " << density_fallbacks.load() << " near-boundary G decided in double-double" << std::endl;
+    }
+    print_profile_summary(std::cout);
+    if (options.verify) {
+        double prime_rate = verifier.verified_count() > 0 ? 100.0 * (double)verifier.prime_count() / (double)verifier.verified_count() : 0.0;
+        std::cout << "Verified Primes: " << verifier.prime_count() << " / " << verifier.verified_count()
+                  << " (" << std::fixed << std::setprecision(2) << prime_rate << "%)" << std::endl;
+        std::cout << "Verification: " << verify_path << std::endl;
+    }
+    if (!written) {
+        std::cerr << "Writing the output failed: " << options.out_file << std::endl;
+    }
+    if (!metrics_written) {
+        std::cerr << "Writing the metrics failed: " << options.metrics_file << std::endl;
+    }
+    return (written && metrics_written) ? 0 : 1;
+}
+
+
+// Prints candidate #k of the chain started at 'start' (the same value line k of
+// a headless run would hold).
+int print_jump_candidate(const std::string& start, long long steps) {
+    PredictionState state(start);
+    auto start_time = std::chrono::steady_clock::now();
+    LGO_JumpAhead(state, (unsigned long long)steps);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::cout << "Candidate #" << steps << ": " << state.prime.to_string() << std::endl;
+    std::cout << "Digits: " << state.digits() << std::endl;
+    std::cout << "Elapsed (s): " << std::fixed << std::setprecision(6) << seconds << std::endl;
+    return 0;
+}
+
+
+// ====================================================================
+// --- GROUND-TRUTH SEGMENTED SIEVE ---
+// ====================================================================
+// For chains that stay within 64 bits (the PRIME_LIST range) the true next
+// prime after every candidate is read from a sieve of the whole window
+// [P_0, P_N + margin] instead of testing candidates one at a time.
+//   - The window is an odd-only bitmap of atomic words.
+//   - Base primes below SIEVE_SMALL_PRIME_LIMIT are applied per cache-sized block
+//     (one task per block, so the block stays in L2 while every small prime
+//     passes over it).
+//   - Larger base primes (up to sqrt(window end), at most 2^32) are never
+//     stored: each task sieves its own slice of the base-prime range in
+//     segments and clears their multiples with atomic fetch_and, since those
+//     primes hit the window at scattered words.
+
+const unsigned long long SIEVE_BLOCK_ODDS = 1ULL << 21;         // 256 KB of bitmap per block task
+const unsigned long long SIEVE_SMALL_PRIME_LIMIT = 1ULL << 22;  // Primes below this go through the blocks
+const unsigned long long SIEVE_BASE_SEGMENT = 1ULL << 21;       // Base-prime sieve segment (numbers, 1 MB odd-only)
+const unsigned long long SIEVE_BASE_TASK_SPAN = 1ULL << 25;     // Base-prime range per large-prime task
+const unsigned long long GROUND_TRUTH_MARGIN = 4096;            // > the largest prime gap below 2^64 (1550)
+
+unsigned long long integer_sqrt(unsigned long long value) {
+    unsigned long long root = (unsigned long long)std::sqrt((double)value);
+    while (root > 0 && root > value / root) { root--; }
+    while ((root + 1) <= value / (root + 1)) { root++; }
+    return root;
+}
+
+// Primes below 'limit' (plain sieve, for the base primes of the base primes).
+std::vector<unsigned int> primes_below(unsigned long long limit) {
+    std::vector<unsigned int> primes;
+    std::vector<bool> composite((size_t)limit, false);
+    for (unsigned long long i = 2; i < limit; i++) {
+        if (composite[(size_t)i]) continue;
+        primes.push_back((unsigned int)i);
+        for (unsigned long long j = i * i; j < limit; j += i) { composite[(size_t)j] = true; }
+    }
+    return primes;
+}
+
+class WindowSieve {
+public:
+    // Sieves the odd numbers in [low, high); 2 is handled by is_prime().
+    WindowSieve(unsigned long long low, unsigned long long high, unsigned threads)
+        : first_odd(low | 1), odd_count(high > (low | 1) ? (high - (low | 1) + 1) / 2 : 0) {
+        word_count = (size_t)((odd_count + 63) / 64);
+        words.reset(new std::atomic<unsigned long long>[word_count]);
+        for (size_t i = 0; i < word_count; i++) { words[i].store(~0ULL, std::memory_order_relaxed); }
+        if (first_odd == 1 && odd_count > 0) { clear(0); } // 1 is not prime
+
+        unsigned long long last = first_odd + 2 * (odd_count - 1);
+        unsigned long long root = odd_count > 0 ? integer_sqrt(last) : 0;
+        std::vector<unsigned int> small = primes_below(std::min(root, SIEVE_SMALL_PRIME_LIMIT) + 1);
+
+        WorkStealingPool pool(threads);
+        for (unsigned long long block = 0; block < odd_count; block += SIEVE_BLOCK_ODDS) {
+            pool.submit([this, block, &small]() {
+                sieve_block(block, std::min(odd_count, block + SIEVE_BLOCK_ODDS), small);
+            });
+        }
+        if (root >= SIEVE_SMALL_PRIME_LIMIT) {
+            std::vector<unsigned int> tiny = primes_below(integer_sqrt(root) + 1);
+            for (unsigned long long from = SIEVE_SMALL_PRIME_LIMIT; from <= root; from += SIEVE_BASE_TASK_SPAN) {
+                unsigned long long to = std::min(root + 1, from + SIEVE_BASE_TASK_SPAN);
+                pool.submit([this, from, to, &tiny]() { sieve_large_primes(from, to, tiny); });
+            }
+        }
+        pool.wait_idle();
+    }
+
+    // Smallest prime > value, or 0 if it lies outside the window.
+    unsigned long long next_prime_after(unsigned long long value) const {
+        if (value < 2) return 2;
+        unsigned long long candidate = (value + 1) | 1;
+        if (candidate < first_odd) candidate = first_odd;
+        for (unsigned long long index = (candidate - first_odd) / 2; index < odd_count;) {
+            unsigned long long word = words[(size_t)(index / 64)].load(std::memory_order_relaxed) >> (index % 64);
+            if (word != 0) {
+                index += (unsigned long long)count_trailing_zeros(word);
+                return index < odd_count ? first_odd + 2 * index : 0;
+            }
+            index = (index / 64 + 1) * 64;
+        }
+        return 0;
+    }
+
+private:
+    static int count_trailing_zeros(unsigned long long word) {
+        int count = 0;
+        while ((word & 1) == 0) { word >>= 1; count++; }
+        return count;
+    }
+
+    void clear(unsigned long long index) {
+        words[(size_t)(index / 64)].fetch_and(~(1ULL << (index % 64)), std::memory_order_relaxed);
+    }
+
+    // First odd multiple of p that is >= max(p * p, first_odd), as a bitmap index.
+    bool first_index(unsigned long long p, unsigned long long& index) const {
+        unsigned long long start = p * p;
+        if (start < first_odd) {
+            start = (first_odd / p + (first_odd % p != 0 ? 1 : 0)) * p;
+            if ((start & 1) == 0) start += p;
+        }
+        index = (start - first_odd) / 2;
+        return index < odd_count;
+    }
+
+    void sieve_block(unsigned long long begin, unsigned long long end, const std::vector<unsigned int>& small) {
+        unsigned long long block_low = first_odd + 2 * begin;
+        for (unsigned int p : small) {
+            if (p == 2) continue;
+            unsigned long long step = p;
+            unsigned long long start = std::max((unsigned long long)p * p, (block_low / step + (block_low % step != 0 ? 1 : 0)) * step);
+            if ((start & 1) == 0) start += step;
+            for (unsigned long long index = (start - first_odd) / 2; index < end; index += step) { clear(index); }
+        }
+    }
+
+    void sieve_large_primes(unsigned long long from, unsigned long long to, const std::vector<unsigned int>& tiny) {
+        // Odd-only segment: entry i stands for low + 2i (low odd).
+        std::vector<char> composite((size_t)(SIEVE_BASE_SEGMENT / 2));
+        for (unsigned long long low = from | 1; low < to; low += SIEVE_BASE_SEGMENT) {
+            unsigned long long high = std::min(to, low + SIEVE_BASE_SEGMENT);
+            std::fill(composite.begin(), composite.end(), 0);
+            for (unsigned int q : tiny) {
+                if (q == 2) continue;
+                unsigned long long start = std::max((unsigned long long)q * q, (low / q + (low % q != 0 ? 1 : 0)) * q);
+                if ((start & 1) == 0) start += q;
+                for (unsigned long long m = start; m < high; m += 2ULL * q) { composite[(size_t)((m - low) / 2)] = 1; }
+            }
+            for (unsigned long long p = low; p < high; p += 2) {
+                if (composite[(size_t)((p - low) / 2)]) continue;
+                unsigned long long index = 0;
+                if (!first_index(p, index)) continue;
+                for (; index < odd_count; index += p) { clear(index); }
+            }
+        }
+    }
+
+    unsigned long long first_odd;
+    unsigned long long odd_count;
+    size_t word_count = 0;
+    std::unique_ptr<std::atomic<unsigned long long>[]> words;
+};
+
+const int GROUND_TRUTH_HISTOGRAM_RANGE = 100; // Errors beyond +/- this are pooled
+
+// Compares the chain's predicted gaps with the true prime gaps for 'count' steps.
+int run_ground_truth(const HeadlessOptions& options) {
+    std::string report_path = (options.out_file == SEQUENCE_FILE) ? "lgo_groundtruth.csv" : options.out_file;
+    unsigned threads = options.threads != 0 ? options.threads : default_thread_count();
+
+    PredictionState state(options.start_prime);
+    PredictionState end_state = state;
+    LGO_JumpAhead(end_state, (unsigned long long)options.count);
+
+    unsigned long long low = 0, high = 0;
+    if (!state.prime.to_u64(low) || !end_state.prime.to_u64(high) || high > ~0ULL - GROUND_TRUTH_MARGIN) {
+        std::cerr << "--groundtruth needs the whole chain below 2^64." << std::endl;
+        return 1;
+    }
+    high += GROUND_TRUTH_MARGIN;
+
+    auto start_time = std::chrono::steady_clock::now();
+    WindowSieve sieve(low, high, threads);
+    double sieve_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::ofstream report(report_path, std::ios::trunc);
+    if (!report.is_open()) {
+        std::cerr << "Could not open report: " << report_path << std::endl;
+        return 1;
+    }
+    report << "step,candidate,predicted_gap,actual_gap\n";
+
+    std::vector<long long> histogram(2 * GROUND_TRUTH_HISTOGRAM_RANGE + 3, 0);
+    long long hits = 0;
+    long long candidate_primes = 0;
+    double absolute_error_sum = 0.0;
+    PredictionMetrics metrics;
+
+    for (long long step = 0; step < options.count; step++) {
+        unsigned long long current = 0;
+        state.prime.to_u64(current);
+        long long predicted = LGO_Predict_Deterministic(state, metrics);
+        long long actual = (long long)(sieve.next_prime_after(current) - current);
+        long long error = predicted - actual;
+
+        report << step << ',' << current << ',' << predicted << ',' << actual << '\n';
+        if (error == 0) { hits++; }
+        if (sieve.next_prime_after(current + (unsigned long long)predicted - 1) == current + (unsigned long long)predicted) { candidate_primes++; }
+        absolute_error_sum += std::fabs((double)error);
+
+        long long bucket = std::max<long long>(-GROUND_TRUTH_HISTOGRAM_RANGE - 1, std::min<long long>(GROUND_TRUTH_HISTOGRAM_RANGE + 1, error));
+        histogram[(size_t)(bucket + GROUND_TRUTH_HISTOGRAM_RANGE + 1)]++;
+    }
+
+    double count = (double)options.count;
+    std::cout << "--- Ground Truth Comparison ---" << std::endl;
+    std::cout << "Steps: " << options.count << std::endl;
+    std::cout << "Window: [" << low << ", " << high << ")" << std::endl;
+    std::cout << "Sieve Time (s): " << std::fixed << std::setprecision(3) << sieve_seconds << std::endl;
+    std::cout << "Exact Next-Prime Hits: " << hits << " (" << std::setprecision(2) << 100.0 * (double)hits / count << "%)" << std::endl;
+    std::cout << "Candidates That Are Prime: " << candidate_primes << " (" << 100.0 * (double)candidate_primes / count << "%)" << std::endl;
+    std::cout << "Mean Absolute Gap Error: " << std::setprecision(3) << absolute_error_sum / count << std::endl;
+    std::cout << "Gap Error Histogram (predicted - actual):" << std::endl;
+    for (size_t i = 0; i < histogram.size(); i++) {
+        if (histogram[i] == 0) continue;
+        long long error = (long long)i - GROUND_TRUTH_HISTOGRAM_RANGE - 1;
+        std::string label = (error < -GROUND_TRUTH_HISTOGRAM_RANGE) ? "<" + std::to_string(-GROUND_TRUTH_HISTOGRAM_RANGE)
+                          : (error > GROUND_TRUTH_HISTOGRAM_RANGE) ? ">" + std::to_string(GROUND_TRUTH_HISTOGRAM_RANGE)
+                          : std::to_string(error);
+        std::cout << "  " << std::setw(6) << label << ": " << histogram[i] << std::endl;
+    }
+    std::cout << "Report: " << report_path << std::endl;
+    return 0;
+}
+
+
+// ====================================================================
+// --- MULTI-CHAIN PARALLEL RUNNER ---
+// ====================================================================
+// Every chain is a self-contained task (own state, metrics and writer), so its
+// output depends only on its seed and count, never on scheduling.
+
+struct ChainJob {
+    std::string seed = "";
+    long long count = 0;
+    std::string out_path = "";
+    bool resume = false; // Continue from out_path when it has a resume point; otherwise start over
+};
+
+struct ChainResult {
+    bool ok = false;
+    long long predictions = 0;
+    long long final_digits = 0;
+};
+
+ChainResult run_chain_job(const ChainJob& job, const SequenceWriterPolicy& policy) {
+    ChainResult result;
+    PredictionState state(job.seed);
+    PredictionMetrics metrics;
+
+    SequenceCheckpoint resume;
+    if (job.resume && load_resume_point(job.out_path, resume)) {
+        restore_state(state, resume);
+        result.predictions = resume.predictions_made;
+    } else {
+        // A re-run replaces the chain; the writer would otherwise append to it.
+        std::error_code error;
+        std::filesystem::remove(job.out_path, error);
+        std::filesystem::remove(checkpoint_path_for(job.out_path), error);
+    }
+
+    SequenceWriter writer;
+    if (!writer.open(job.out_path, policy, &state.prime)) {
+        return result;
+    }
+    writer.attach_checkpoint(&state, &result.predictions);
+
+    for (long long step = 0; step < job.count; step++) {
+        LGO_Predict_Deterministic(state, metrics);
+        result.predictions++;
+        writer.write(state.prime, metrics.final_gap);
+    }
+
+    result.ok = writer.close();
+    result.final_digits = state.digits();
+    return result;
+}
+
+bool load_chain_seeds(const std::string& source, std::vector<std::string>& seeds) {
+    if (source == "builtin") {
+        for (const auto& item : PRIME_LIST) { seeds.push_back(item.second); }
+        return true;
+    }
+    SequenceReader reader;
+    if (!reader.open(source)) {
+        std::cerr << "Could not open seed file: " << source << std::endl;
+        return false;
+    }
+    bool valid = true;
+    reader.for_each_record([&](std::string_view seed) {
+        if (seed.find_first_not_of("0123456789") != std::string_view::npos) {
+            std::cerr << "Invalid seed: " << seed.substr(0, 40) << std::endl;
+            valid = false;
+        }
+        seeds.emplace_back(seed);
+    });
+    return valid && !seeds.empty();
+}
+
+int run_multi_chain(const HeadlessOptions& options) {
+    std::vector<std::string> seeds;
+    if (!load_chain_seeds(options.chains_source, seeds)) {
+        return 1;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(options.out_dir, error);
+    if (error) {
+        std::cerr << "Could not create output directory: " << options.out_dir << std::endl;
+        return 1;
+    }
+
+    const char* extension = (options.writer_policy.format == SEQUENCE_BINARY) ? ".lgob" : ".txt";
+    std::vector<ChainJob> jobs(seeds.size());
+    for (size_t i = 0; i < seeds.size(); i++) {
+        jobs[i].seed = seeds[i];
+        jobs[i].count = options.count;
+        jobs[i].out_path = (std::filesystem::path(options.out_dir) / ("chain_" + std::to_string(i) + extension)).string();
+        jobs[i].resume = options.resume;
+    }
+
+    std::vector<ChainResult> results(jobs.size());
+    unsigned threads = options.threads != 0 ? options.threads : default_thread_count();
+    threads = (unsigned)std::min<size_t>(threads, jobs.size());
+
+    auto start_time = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(threads);
+        for (size_t i = 0; i < jobs.size(); i++) {
+            pool.submit([&, i]() { results[i] = run_chain_job(jobs[i], options.writer_policy); });
+        }
+        pool.wait_idle();
+    }
+    auto end_time = std::chrono::steady_clock::now();
+
+    // Manifest in seed order, independent of which worker finished first.
+    std::ofstream manifest((std::filesystem::path(options.out_dir) / "chains.txt").string(), std::ios::trunc);
+    long long total_predictions = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        total_predictions += results[i].predictions;
+        if (!results[i].ok) failed++;
+        manifest << i << " " << (results[i].ok ? "ok" : "failed") << " " << results[i].predictions << " "
+                 << results[i].final_digits << " " << jobs[i].out_path << " " << jobs[i].seed << "\n";
+    }
+    manifest.close();
+
+    double seconds = std::chrono::duration<double>(end_time - start_time).count();
+    double steps_per_sec = (seconds > 0.0) ? (double)total_predictions / seconds : 0.0;
+
+    std::cout << "--- Multi-Chain Run Complete ---" << std::endl;
+    std::cout << "Chains: " << jobs.size() << " (" << failed << " failed)   Threads: " << threads << std::endl;
+    std::cout << "Total Predictions: " << total_predictions << std::endl;
+    std::cout << "Elapsed (s): " << std::fixed << std::setprecision(3) << seconds << std::endl;
+    std::cout << "Throughput (predictions/s): " << std::fixed << std::setprecision(1) << steps_per_sec << std::endl;
+    std::cout << "Output: " << options.out_dir << std::endl;
+    print_profile_summary(std::cout);
+    return failed == 0 ? 0 : 1;
+}
+
+
+// ====================================================================
+// --- PARAMETER SWEEP ---
+// ====================================================================
+// Scores model variants against the true prime gaps that follow each seed
+// (all below 2^64). Everything a variant does not change (the primes, their
+// digit counts, ln estimates, residues and actual gaps) is computed once into
+// flat arrays; a variant is then only the few operations of its final_gap()
+// per point, and variants are spread over the thread pool.
+
+const size_t SWEEP_VARIANTS_PER_TASK = 8;
+const unsigned long long SWEEP_MAX_WINDOW = 1ULL << 30; // Numbers per sieve window (64 MB bitmap)
+
+struct SweepPoints {
+    std::vector<int> digits;
+    std::vector<double> ln_model;
+    std::vector<unsigned long long> leading_mantissa;
+    std::vector<unsigned char> mod_84;
+    std::vector<unsigned char> special; // As in LGO_Model::final_gap()
+    std::vector<int> actual_gap;
+    long long standard_mismatches = 0; // LGO_Model::standard() vs LGO_ComputeMetrics() (must stay 0)
+
+    size_t size() const { return actual_gap.size(); }
+};
+
+// 'count' consecutive primes from 'seed' (the first point is the seed itself).
+bool collect_sweep_points(const std::string& seed, long long count, unsigned threads, SweepPoints& points) {
+    BigInt start(seed);
+    unsigned long long current = 0;
+    if (!start.to_u64(current) || current < 2) {
+        std::cerr << "Sweep seeds must lie in [2, 2^64): " << seed.substr(0, 40) << std::endl;
+        return false;
+    }
+    const LGO_Model standard = LGO_Model::standard();
+    long long collected = 0;
+    while (collected < count) {
+        // About ln(P) per prime, with room to spare; short windows are simply repeated.
+        double expected = (double)(count - collected) * std::log((double)current) * 1.5;
+        unsigned long long span = (unsigned long long)std::min((double)SWEEP_MAX_WINDOW, expected) + GROUND_TRUTH_MARGIN;
+        if (current > ~0ULL - span) {
+            std::cerr << "Sweep points would pass 2^64 after seed " << seed.substr(0, 40) << std::endl;
+            return false;
+        }
+        WindowSieve sieve(current, current + span, threads);
+        for (; collected < count; collected++) {
+            unsigned long long next = sieve.next_prime_after(current);
+            if (next == 0) break;
+            PredictionState state{BigInt(std::to_string(current))};
+            points.digits.push_back((int)state.leading.digits);
+            points.ln_model.push_back(state.leading.ln_model());
+            points.leading_mantissa.push_back(state.leading.leading_mantissa);
+            points.mod_84.push_back((unsigned char)state.mod_84);
+            points.special.push_back((unsigned char)(state.is_small_special() ? (state.leading.leading_mantissa == 2 ? 1 : 2) : 0));
+            points.actual_gap.push_back((int)(next - current));
+            if (standard.final_gap(state) != LGO_ComputeMetrics(state).final_gap) { points.standard_mismatches++; }
+            current = next;
+        }
+    }
+    return true;
+}
+
+struct SweepScore {
+    long long hits = 0;
+    double absolute_error_sum = 0.0;
+    double error_sum = 0.0;
+};
+
+SweepScore evaluate_variant(const LGO_Model& model, const SweepPoints& points) {
+    SweepScore score;
+    long long last_digits = -1;
+    long long base_gap = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (points.digits[i] != last_digits) {
+            last_digits = points.digits[i];
+            base_gap = model.base_gap(last_digits);
+        }
+        long long delta = points.special[i] != 0 ? model.delta_special[points.special[i] - 1] : model.delta_84[points.mod_84[i]];
+        long long error = LGO_FinalGap(base_gap, delta, model.density(points.ln_model[i], points.digits[i], points.leading_mantissa[i])) - points.actual_gap[i];
+        if (error == 0) { score.hits++; }
+        score.absolute_error_sum += std::fabs((double)error);
+        score.error_sum += (double)error;
+    }
+    return score;
+}
+
+// "<from>:<to>:<count>" (evenly spaced, ends included) or a single value.
+bool parse_sweep_range(const std::string& text, std::vector<double>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string part;
+    std::vector<double> fields;
+    while (std::getline(stream, part, ':')) {
+        char* end = nullptr;
+        double value = std::strtod(part.c_str(), &end);
+        if (part.empty() || *end != '\0' || !(value > 0.0)) return false;
+        fields.push_back(value);
+    }
+    if (fields.size() == 1) {
+        values.push_back(fields[0]);
+        return true;
+    }
+    if (fields.size() != 3 || fields[2] < 1.0 || fields[2] != std::floor(fields[2])) return false;
+    long long steps = (long long)fields[2];
+    for (long long i = 0; i < steps; i++) {
+        values.push_back(steps == 1 ? fields[0] : fields[0] + (fields[1] - fields[0]) * (double)i / (double)(steps - 1));
+    }
+    return true;
+}
+
+bool load_sweep_variants(const HeadlessOptions& options, std::vector<LGO_Model>& variants) {
+    if (options.sweep_source == "grid") {
+        std::vector<double> phis = {PHI_DAMPENER};
+        std::vector<double> divisors = {50.0};
+        if ((!options.sweep_phi.empty() && !parse_sweep_range(options.sweep_phi, phis)) ||
+            (!options.sweep_divisor.empty() && !parse_sweep_range(options.sweep_divisor, divisors))) {
+            std::cerr << "--sweep-phi / --sweep-divisor expect <from>:<to>:<count> or a positive value." << std::endl;
+            return false;
+        }
+        for (double phi : phis) {
+            for (double divisor : divisors) {
+                LGO_Model model = LGO_Model::standard();
+                model.phi_dampener = phi;
+                model.base_gap_divisor = (long double)divisor;
+                model.prepare();
+                variants.push_back(model);
+            }
+        }
+        return true;
+    }
+
+    std::ifstream file(options.sweep_source);
+    if (!file.is_open()) {
+        std::cerr << "Could not open variant file: " << options.sweep_source << std::endl;
+        return false;
+    }
+    std::string line;
+    long long line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        LGO_Model model;
+        if (!parse_model_variant(line, model)) {
+            std::cerr << "Invalid variant on line " << line_number << ": " << line << std::endl;
+            return false;
+        }
+        variants.push_back(model);
+    }
+    return !variants.empty();
+}
+
+int run_sweep(const HeadlessOptions& options) {
+    std::vector<LGO_Model> variants;
+    std::vector<std::string> seeds;
+    if (!load_sweep_variants(options, variants) || !load_chain_seeds(options.chains_source.empty() ? "builtin" : options.chains_source, seeds)) {
+        return 1;
+    }
+    std::string report_path = (options.out_file == SEQUENCE_FILE) ? "lgo_sweep.csv" : options.out_file;
+    unsigned threads = options.threads != 0 ? options.threads : default_thread_count();
+
+    auto start_time = std::chrono::steady_clock::now();
+    SweepPoints points;
+    for (const std::string& seed : seeds) {
+        if (!collect_sweep_points(seed, options.count, threads, points)) return 1;
+    }
+    if (points.standard_mismatches != 0) {
+        std::cerr << "LGO_Model::standard() disagrees with the compiled model at " << points.standard_mismatches << " points." << std::endl;
+        return 1;
+    }
+    double prepare_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    start_time = std::chrono::steady_clock::now();
+    std::vector<SweepScore> scores(variants.size());
+    {
+        WorkStealingPool pool(threads);
+        for (size_t first = 0; first < variants.size(); first += SWEEP_VARIANTS_PER_TASK) {
+            pool.submit([&, first]() {
+                size_t last = std::min(variants.size(), first + SWEEP_VARIANTS_PER_TASK);
+                for (size_t v = first; v < last; v++) { scores[v] = evaluate_variant(variants[v], points); }
+            });
+        }
+        pool.wait_idle();
+    }
+    SweepScore baseline = evaluate_variant(LGO_Model::standard(), points);
+    double sweep_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::ofstream report(report_path, std::ios::trunc);
+    if (!report.is_open()) {
+        std::cerr << "Could not open report: " << report_path << std::endl;
+        return 1;
+    }
+    double count = (double)points.size();
+    report << "variant,phi,divisor,d12,d7,points,hits,hit_rate,mean_abs_error,mean_error\n";
+    report << std::setprecision(12);
+    for (size_t v = 0; v < variants.size(); v++) {
+        const LGO_Model& model = variants[v];
+        report << v << ',' << model.phi_dampener << ',' << (double)model.base_gap_divisor << ',';
+        for (int i = 0; i < ULAM_CORRECTION_SIZE; i++) { report << (i ? ";" : "") << model.delta_12[i]; }
+        report << ',';
+        for (int i = 0; i < MOD_7_CORRECTION_SIZE; i++) { report << (i ? ";" : "") << model.delta_7[i]; }
+        report << ',' << points.size() << ',' << scores[v].hits << ',' << (double)scores[v].hits / count << ','
+               << scores[v].absolute_error_sum / count << ',' << scores[v].error_sum / count << '\n';
+    }
+    report.close();
+
+    std::vector<size_t> ranking(variants.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(ranking.begin(), ranking.end(), [&](size_t a, size_t b) {
+        if (scores[a].hits != scores[b].hits) return scores[a].hits > scores[b].hits;
+        return scores[a].absolute_error_sum < scores[b].absolute_error_sum;
+    });
+
+    double evaluations = (double)variants.size() * count;
+    std::cout << "--- Parameter Sweep Complete ---" << std::endl;
+    std::cout << "Variants: " << variants.size() << "   Seeds: " << seeds.size() << "   Points: " << points.size() << "   Threads: " << threads << std::endl;
+    std::cout << "Shared Precomputation (s): " << std::fixed << std::setprecision(3) << prepare_seconds << std::endl;
+    std::cout << "Sweep (s): " << sweep_seconds << "   (" << std::setprecision(1) << (sweep_seconds > 0.0 ? evaluations / sweep_seconds : 0.0) << " variant-points/s)" << std::endl;
+    std::cout << "Standard Model: " << baseline.hits << " hits (" << std::setprecision(2) << 100.0 * (double)baseline.hits / count
+              << "%), mean abs error " << std::setprecision(3) << baseline.absolute_error_sum / count << std::endl;
+    std::cout << "Best Variants:" << std::endl;
+    for (size_t rank = 0; rank < std::min<size_t>(5, ranking.size()); rank++) {
+        size_t v = ranking[rank];
+        std::cout << "  #" << v << "  " << scores[v].hits << " hits (" << std::setprecision(2) << 100.0 * (double)scores[v].hits / count
+                  << "%), mean abs error " << std::setprecision(3) << scores[v].absolute_error_sum / count << "  " << describe_model(variants[v]) << std::endl;
+    }
+    std::cout << "Report: " << report_path << std::endl;
+    return 0;
+}
+
+
+// ====================================================================
+// --- DISTRIBUTED CHAIN SHARDING ---
+// ====================================================================
+// One long chain split across worker processes, on this machine or others.
+// The coordinator cuts the run into shards of --shard-steps steps. A worker
+// jumps from the chain's starting value to its shard with LGO_JumpAhead and
+// predicts it. For text output it also renders the shard's records, so the
+// coordinator only appends bytes in step order and re-reads the end value for
+// its checkpoints; rendering, the dominant per-record cost of text, scales
+// with the workers. Binary shards come back as gaps: a binary record costs the
+// coordinator one varint and a small add, and its blocks must be cut by the
+// single writer. Either way the output (checkpoints included) is
+// byte-identical to a serial run with the same writer options. Every shard
+// carries a hash of the value it started from, which has to match the value
+// the coordinator reached.
+//
+// Messages are a u32 length followed by the payload:
+//   worker      -> "HELLO " model version
+//   coordinator -> "JOB " u64 offset | u64 steps | u8 'T' (text) or 'B' | starting value (decimal), or "DONE"
+//   worker      -> "TEXT" u64 offset | u64 start hash | u32 end length | end value (decimal) | records
+//                  "GAPS" u64 offset | u64 start hash | one zigzag varint per gap
+// A length above what the receiver can expect (shard_reply_limit() for a
+// result, fixed caps otherwise) drops the connection before anything is allocated.
+
+const size_t SHARD_WINDOW_PER_WORKER = 2; // Shards handed out ahead of the writer, per connected worker
+const int SHARD_CONNECT_TIMEOUT_MS = 5000;
+const size_t SHARD_JOB_HEADER_BYTES = 21;
+const size_t SHARD_GAPS_HEADER_BYTES = 20;
+const size_t SHARD_TEXT_HEADER_BYTES = 24;
+const long long SHARD_TEXT_BYTES = 16LL << 20; // Text shards are cut to about this size
+const long long SHARD_DIGIT_MARGIN = 20;       // Digit growth allowed for when sizing text shards
+const size_t SHARD_HELLO_MAX_BYTES = 256;
+const size_t SHARD_JOB_MAX_BYTES = 256u << 20; // Header plus a starting value of up to ~256M digits
+const size_t SHARD_VARINT_MAX_BYTES = 10;
+
+void put_zigzag(std::string& out, long long value) {
+    put_varint(out, ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+}
+
+bool get_zigzag(const unsigned char*& cursor, const unsigned char* end, long long& value) {
+    unsigned long long raw = 0;
+    if (!get_varint(cursor, end, raw)) return false;
+    value = (long long)(raw >> 1) ^ -(long long)(raw & 1);
+    return true;
+}
+
+bool send_shard_message(const Socket& socket, const std::string& payload) {
+    std::string message;
+    message.reserve(payload.size() + 4);
+    put_u32(message, (unsigned int)payload.size());
+    message.append(payload);
+    return socket.send_all(message, HTTP_CLIENT_TIMEOUT_MS);
+}
+
+// Waits for as long as the peer stays connected, or until 'stop' is set.
+bool receive_shard_bytes(const Socket& socket, std::string& out, size_t bytes, const std::atomic<bool>* stop) {
+    out.resize(bytes);
+    size_t received = 0;
+    while (received < bytes) {
+        if (stop != nullptr && stop->load(std::memory_order_relaxed)) return false;
+        if (!socket.wait(false, HTTP_POLL_MS)) continue;
+        long long read = socket.receive(&out[received], bytes - received, 0);
+        if (read <= 0) return false; // Closed or failed
+        received += (size_t)read;
+    }
+    return true;
+}
+
+// False (without reading on) when the announced length exceeds 'max_bytes'.
+bool receive_shard_message(const Socket& socket, std::string& payload, size_t max_bytes, const std::atomic<bool>* stop = nullptr) {
+    std::string length;
+    if (!receive_shard_bytes(socket, length, 4, stop)) return false;
+    size_t bytes = get_u32((const unsigned char*)length.data());
+    if (bytes > max_bytes) return false;
+    return receive_shard_bytes(socket, payload, bytes, stop);
+}
+
+// Largest valid result for a shard of 'steps' steps of a chain that started at
+// 'start_digits' digits: every text record (and the end value) within the
+// digit margin, or one full-width varint per gap.
+size_t shard_reply_limit(unsigned long long steps, bool text, size_t start_digits) {
+    if (text) {
+        return SHARD_TEXT_HEADER_BYTES + (size_t)(steps + 1) * (start_digits + (size_t)SHARD_DIGIT_MARGIN + 1);
+    }
+    return SHARD_GAPS_HEADER_BYTES + (size_t)steps * SHARD_VARINT_MAX_BYTES;
+}
+
+struct ShardResult {
+    unsigned long long start_hash = 0;
+    std::vector<long long> gaps; // Binary shards
+    std::string end_value;       // Text shards: the last record's value, and the message
+    std::string message;         // holding the records from 'text_offset' on
+    size_t text_offset = 0;
+
+    std::string_view text() const { return std::string_view(message).substr(text_offset); }
+};
+
+bool decode_shard_result(std::string& message, unsigned long long offset, unsigned long long steps, bool text, ShardResult& result) {
+    const unsigned char* cursor = (const unsigned char*)message.data();
+    const unsigned char* end = cursor + message.size();
+    if (message.size() < SHARD_GAPS_HEADER_BYTES || message.compare(0, 4, text ? "TEXT" : "GAPS") != 0 || get_u64(cursor + 4) != offset) {
+        return false;
+    }
+    result.start_hash = get_u64(cursor + 12);
+    if (text) {
+        if (message.size() < SHARD_TEXT_HEADER_BYTES) return false;
+        size_t end_length = get_u32(cursor + 20);
+        if (end_length == 0 || end_length > message.size() - SHARD_TEXT_HEADER_BYTES) return false;
+        result.end_value = message.substr(SHARD_TEXT_HEADER_BYTES, end_length);
+        result.text_offset = SHARD_TEXT_HEADER_BYTES + end_length;
+        result.message = std::move(message); // The records are written straight from here
+        // Exactly 'steps' records, the last of them the end value.
+        std::string_view records = result.text();
+        size_t tail = result.end_value.size() + 1;
+        return (unsigned long long)std::count(records.begin(), records.end(), '\n') == steps && records.size() >= tail &&
+               records.substr(records.size() - tail, result.end_value.size()) == result.end_value &&
+               (records.size() == tail || records[records.size() - tail - 1] == '\n');
+    }
+    cursor += SHARD_GAPS_HEADER_BYTES;
+    result.gaps.resize((size_t)steps);
+    for (long long& gap : result.gaps) {
+        if (!get_zigzag(cursor, end, gap)) return false;
+    }
+    return cursor == end;
+}
+
+// Shared by the coordinator's writer loop and its per-worker threads. Shards
+// are handed out in order, at most a window ahead of the writer, and a shard
+// whose worker disconnects goes back to the front of the queue.
+class ShardBoard {
+public:
+    ShardBoard(long long total_steps, long long steps_per_shard)
+        : total(total_steps), shard_steps(steps_per_shard), shards((total_steps + steps_per_shard - 1) / steps_per_shard) {}
+
+    long long shard_count() const { return shards; }
+    long long offset(long long shard) const { return shard * shard_steps; }
+    long long length(long long shard) const { return std::min(shard_steps, total - offset(shard)); }
+
+    void add_worker() {
+        std::lock_guard<std::mutex> lock(mutex);
+        workers++;
+        workers_seen++;
+        changed.notify_all();
+    }
+
+    void remove_worker() {
+        std::lock_guard<std::mutex> lock(mutex);
+        workers--;
+    }
+
+    long long worker_count_seen() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return workers_seen;
+    }
+
+    // False once every shard has been applied (or the run is stopping).
+    bool take(long long& shard) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (stopping.load(std::memory_order_relaxed) || applied >= shards) return false;
+            if (!returned.empty()) {
+                shard = returned.front();
+                returned.pop_front();
+                return true;
+            }
+            size_t window = (size_t)std::max(workers, 1LL) * SHARD_WINDOW_PER_WORKER;
+            if (next_shard < shards && next_shard < applied + (long long)window) {
+                shard = next_shard++;
+                return true;
+            }
+            changed.wait_for(lock, std::chrono::milliseconds(HTTP_POLL_MS));
+        }
+    }
+
+    void give_back(long long shard) {
+        std::lock_guard<std::mutex> lock(mutex);
+        returned.push_front(shard);
+        changed.notify_all();
+    }
+
+    void deliver(long long shard, ShardResult&& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready[shard] = std::move(result);
+        changed.notify_all();
+    }
+
+    // Writer side: the next shard in step order, waiting up to 'timeout_ms'.
+    bool next_in_order(ShardResult& result, int timeout_ms) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto found = ready.find(applied);
+        if (found == ready.end()) {
+            changed.wait_for(lock, std::chrono::milliseconds(timeout_ms));
+            found = ready.find(applied);
+            if (found == ready.end()) return false;
+        }
+        result = std::move(found->second);
+        ready.erase(found);
+        applied++;
+        changed.notify_all();
+        return true;
+    }
+
+    void stop() {
+        stopping.store(true, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        changed.notify_all();
+    }
+
+    std::atomic<bool> stopping{false};
+
+private:
+    const long long total;
+    const long long shard_steps;
+    const long long shards;
+
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    long long next_shard = 0;
+    long long applied = 0;
+    long long workers = 0;
+    long long workers_seen = 0;
+    std::deque<long long> returned;
+    std::map<long long, ShardResult> ready;
+};
+
+// One connected worker: the handshake, then jobs until the board runs dry.
+void serve_shard_connection(Socket connection, ShardBoard& board, const std::string& start_text, bool text) {
+    std::string message;
+    if (!receive_shard_message(connection, message, SHARD_HELLO_MAX_BYTES, &board.stopping) || message != "HELLO " + LGO_MODEL_VERSION) {
+        if (!board.stopping.load()) {
+            std::cerr << "Rejected a worker (different model version or protocol)." << std::endl;
+        }
+        return;
+    }
+    board.add_worker();
+
+    long long shard = 0;
+    while (board.take(shard)) {
+        std::string request = "JOB ";
+        put_u64(request, (unsigned long long)board.offset(shard));
+        put_u64(request, (unsigned long long)board.length(shard));
+        request.push_back(text ? 'T' : 'B');
+        request.append(start_text);
+
+        ShardResult result;
+        size_t reply_limit = shard_reply_limit((unsigned long long)board.length(shard), text, start_text.size());
+        if (!send_shard_message(connection, request) || !receive_shard_message(connection, message, reply_limit, &board.stopping) ||
+            !decode_shard_result(message, (unsigned long long)board.offset(shard), (unsigned long long)board.length(shard), text, result)) {
+            board.give_back(shard);
+            board.remove_worker();
+            if (!board.stopping.load()) {
+                std::cerr << "Lost a worker; shard " << shard << " goes to the next one." << std::endl;
+            }
+            return;
+        }
+        board.deliver(shard, std::move(result));
+    }
+    send_shard_message(connection, "DONE");
+    board.remove_worker();
+}
+
+int run_shard_coordinator(const HeadlessOptions& options) {
+    PredictionState state;
+    if (!load_start_state(options, state)) {
+        return 1;
+    }
+    SequenceWriter writer;
+    if (!writer.open(options.out_file, options.writer_policy, &state.prime)) {
+        std::cerr << "Could not open output file (or it is in the other format): " << options.out_file << std::endl;
+        return 1;
+    }
+    writer.attach_checkpoint(&state, &predictions_made);
+
+    Socket listener;
+    if (!listener.listen_on(options.shard_bind, options.shard_port)) {
+        std::cerr << "Could not listen on " << options.shard_bind << ":" << options.shard_port << std::endl;
+        return 1;
+    }
+    const bool text = options.writer_policy.format == SEQUENCE_TEXT;
+    long long shard_steps = options.shard_steps;
+    if (text) {
+        shard_steps = std::max(1LL, std::min(shard_steps, SHARD_TEXT_BYTES / (state.digits() + SHARD_DIGIT_MARGIN + 1)));
+    }
+    ShardBoard board(options.count, shard_steps);
+    std::cout << "Coordinator: " << board.shard_count() << " shards of up to " << shard_steps << " steps; workers connect with --worker "
+              << options.shard_bind << ":" << listener.local_port() << std::endl;
+
+    const std::string start_text = state.prime.to_string();
+    std::vector<std::thread> connections;
+    long long predictions_at_start = predictions_made;
+    auto start_time = std::chrono::steady_clock::now();
+
+    bool ok = true;
+    long long applied = 0;
+    double apply_seconds = 0.0; // Time the coordinator itself spends per shard: the scaling ceiling
+    ShardResult result;
+    while (applied < board.shard_count()) {
+        if (listener.wait(false, 0)) {
+            Socket client = listener.accept_client();
+            if (client.is_open()) {
+                connections.emplace_back(serve_shard_connection, std::move(client), std::ref(board), std::cref(start_text), text);
+            }
+        }
+        if (!board.next_in_order(result, HTTP_POLL_MS)) {
+            continue;
+        }
+        if (result.start_hash != segment_seed_hash(state.prime)) {
+            std::cerr << "Shard " << applied << " does not continue the chain; stopping." << std::endl;
+            ok = false;
+            break;
+        }
+        auto apply_start = std::chrono::steady_clock::now();
+        if (text) {
+            long long records = board.length(applied);
+            state.reset(BigInt(result.end_value)); // Before the write, so a flush checkpoints the shard's end
+            predictions_made += records;
+            writer.write_rendered(result.text(), records);
+        } else {
+            for (long long gap : result.gaps) {
+                state.advance(gap);
+                predictions_made++;
+                writer.write(state.prime, gap);
+            }
+        }
+        apply_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - apply_start).count();
+        applied++;
+    }
+    board.stop();
+    for (std::thread& connection : connections) { connection.join(); }
+    listener.close();
+    if (!writer.close()) {
+        std::cerr << "Writing the output failed: " << options.out_file << std::endl;
+        ok = false;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    long long steps_run = predictions_made - predictions_at_start;
+    double steps_per_sec = (seconds > 0.0) ? (double)steps_run / seconds : 0.0;
+
+    std::cout << "--- Sharded Run " << (ok ? "Complete" : "Stopped") << " ---" << std::endl;
+    std::cout << "Shards Applied: " << applied << " / " << board.shard_count() << "   Workers: " << board.worker_count_seen() << std::endl;
+    std::cout << "Predictions This Run: " << steps_run << std::endl;
+    std::cout << "Total Predictions: " << predictions_made << std::endl;
+    std::cout << "Final Candidate Digits: " << state.digits() << std::endl;
+    std::cout << "Elapsed (s): " << std::fixed << std::setprecision(3) << seconds << std::endl;
+    std::cout << "Throughput (predictions/s): " << std::fixed << std::setprecision(1) << steps_per_sec << std::endl;
+    std::cout << "Coordinator Apply (s): " << std::fixed << std::setprecision(3) << apply_seconds
+              << "   Ceiling (predictions/s): " << std::setprecision(1) << (apply_seconds > 0.0 ? (double)steps_run / apply_seconds : 0.0) << std::endl;
+    std::cout << "Output: " << options.out_file << std::endl;
+    return ok ? 0 : 1;
+}
+
+// Serves shards for one coordinator until it sends DONE.
+int run_shard_worker(const std::string& endpoint) {
+    size_t colon = endpoint.rfind(':');
+    long long port = 0;
+    if (colon == std::string::npos || colon == 0 || !parse_count_value("--worker", endpoint.substr(colon + 1), port) || port == 0 || port > 65535) {
+        std::cerr << "--worker expects <host>:<port>" << std::endl;
+        return 2;
+    }
+    Socket coordinator;
+    if (!coordinator.connect_to(endpoint.substr(0, colon), (int)port, SHARD_CONNECT_TIMEOUT_MS) ||
+        !send_shard_message(coordinator, "HELLO " + LGO_MODEL_VERSION)) {
+        std::cerr << "Could not reach coordinator: " << endpoint << std::endl;
+        return 1;
+    }
+    std::cout << "Connected to coordinator " << endpoint << std::endl;
+
+    // A later shard of the same chain jumps on from where the previous one ended.
+    std::string chain_start = "";
+    PredictionState state;
+    unsigned long long state_offset = 0;
+    PredictionMetrics metrics;
+    DecimalMirror mirror; // Text shards: the previous record, as in SequenceWriter
+    std::string records;
+
+    long long shards = 0;
+    long long steps_run = 0;
+    bool done = false;
+    std::string message, reply;
+    auto start_time = std::chrono::steady_clock::now();
+    while (receive_shard_message(coordinator, message, SHARD_JOB_MAX_BYTES)) {
+        if (message == "DONE") {
+            done = true;
+            break;
+        }
+        std::string_view start_text = std::string_view(message).substr(std::min(message.size(), SHARD_JOB_HEADER_BYTES));
+        if (message.size() <= SHARD_JOB_HEADER_BYTES || message.compare(0, 4, "JOB ") != 0 ||
+            start_text.find_first_not_of("0123456789") != std::string_view::npos) {
+            std::cerr << "Unexpected message from coordinator." << std::endl;
+            return 1;
+        }
+        unsigned long long offset = get_u64((const unsigned char*)message.data() + 4);
+        unsigned long long steps = get_u64((const unsigned char*)message.data() + 12);
+        bool text = message[20] == 'T';
+        if (start_text != chain_start || offset < state_offset) {
+            chain_start.assign(start_text);
+            state.reset(BigInt(start_text));
+            state_offset = 0;
+        }
+        LGO_JumpAhead(state, offset - state_offset);
+
+        reply = text ? "TEXT" : "GAPS";
+        put_u64(reply, offset);
+        put_u64(reply, segment_seed_hash(state.prime));
+        if (text) {
+            records.clear();
+            mirror.invalidate();
+            for (unsigned long long i = 0; i < steps; i++) {
+                long long gap = LGO_Predict_Deterministic(state, metrics);
+                append_text_record(records, mirror, state.prime, gap);
+            }
+            std::string end_value = state.prime.to_string();
+            put_u32(reply, (unsigned int)end_value.size());
+            reply.append(end_value);
+            reply.append(records);
+        } else {
+            for (unsigned long long i = 0; i < steps; i++) {
+                put_zigzag(reply, LGO_Predict_Deterministic(state, metrics));
+            }
+        }
+        state_offset = offset + steps;
+        if (!send_shard_message(coordinator, reply)) {
+            break;
+        }
+        shards++;
+        steps_run += (long long)steps;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << "--- Worker " << (done ? "Done" : "Disconnected") << " ---" << std::endl;
+    std::cout << "Shards: " << shards << "   Predictions: " << steps_run << std::endl;
+    std::cout << "Elapsed (s): " << std::fixed << std::setprecision(3) << seconds << std::endl;
+    print_profile_summary(std::cout);
+    return done ? 0 : 1;
+}
+
+
+// ====================================================================
+// --- BENCHMARK SUITE ---
+// ====================================================================
+// Times each stage of the predictor separately across starting-prime sizes,
+// from the PRIME_LIST entries up to 100k digits, and writes the results as JSON
+// so versions can be compared. A stage that throws at some size is reported as
+// unsupported rather than aborting the sweep.
+
+const size_t BENCH_BATCH_LANES = 256; // Lanes in the batch.step stage (ns_per_op covers all of them)
+
+struct BenchOptions {
+    std::string json_file = "lgo_bench.json";
+    long long max_digits = 100000;
+    long long budget_ms = 200; // Per stage and size
+};
+
+struct BenchResult {
+    long long digits = 0;
+    std::string stage = "";
+    bool supported = true;
+    long long iterations = 0;
+    double ns_per_op = 0.0;
+    double allocs_per_op = 0.0;
+};
+
+volatile unsigned long long bench_sink = 0; // Keeps results observable
+
+// Runs 'op' in doubling batches until the time budget is spent.
+template <typename Op>
+BenchResult bench_stage(const std::string& stage, long long digits, long long budget_ms, Op&& op) {
+    BenchResult result;
+    result.stage = stage;
+    result.digits = digits;
+
+    double budget_ns = (double)budget_ms * 1e6;
+    double elapsed_ns = 0.0;
+    unsigned long long allocations = 0;
+    long long batch = 1;
+
+    try {
+        while (elapsed_ns < budget_ns) {
+            unsigned long long allocations_before = thread_allocation_count;
+            auto start = std::chrono::steady_clock::now();
+            for (long long i = 0; i < batch; i++) { op(); }
+            auto end = std::chrono::steady_clock::now();
+            allocations += thread_allocation_count - allocations_before;
+            elapsed_ns += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            result.iterations += batch;
+            if (batch < (1LL << 24)) { batch *= 2; }
+        }
+    } catch (const std::exception&) {
+        result.supported = false;
+        return result;
+    }
+
+    result.ns_per_op = elapsed_ns / (double)result.iterations;
+    result.allocs_per_op = (double)allocations / (double)result.iterations;
+    return result;
+}
+
+// Odd decimal value of exactly 'digits' digits.
+std::string random_decimal_seed(std::mt19937_64& generator, long long digits) {
+    std::string seed((size_t)digits, '0');
+    seed[0] = (char)('1' + generator() % 9);
+    for (long long i = 1; i < digits; i++) { seed[(size_t)i] = (char)('0' + generator() % 10); }
+    seed[(size_t)digits - 1] = "1379"[generator() % 4];
+    return seed;
+}
+
+// Deterministic odd seed of the requested length (sizes not in PRIME_LIST).
+std::string bench_seed(long long digits) {
+    for (const auto& item : PRIME_LIST) {
+        if ((long long)item.second.length() == digits) return item.second;
+    }
+    std::mt19937_64 generator(0x4C474FULL + (unsigned long long)digits);
+    return random_decimal_seed(generator, digits);
+}
+
+std::vector<BenchResult> bench_size(long long digits, long long budget_ms) {
+    std::vector<BenchResult> results;
+    const std::string seed = bench_seed(digits);
+
+    // --- String reference path ---
+    {
+        std::string current = seed;
+        PredictionMetrics metrics;
+        results.push_back(bench_stage("string.predict", digits, budget_ms, [&]() {
+            auto step = LGO_Predict_Deterministic(current, metrics);
+            current = std::move(step.second);
+        }));
+    }
+    {
+        std::string current = seed;
+        PredictionMetrics metrics;
+        StepScratch scratch;
+        results.push_back(bench_stage("string.predict_scratch", digits, budget_ms, [&]() {
+            bench_sink += (unsigned long long)LGO_Predict_Deterministic(current, metrics, scratch);
+            current.swap(scratch.next);
+        }));
+    }
+    {
+        std::string sum;
+        results.push_back(bench_stage("string.add_strings", digits, budget_ms, [&]() {
+            add_strings(seed, 20, sum);
+            bench_sink += sum.length();
+        }));
+    }
+    results.push_back(bench_stage("string.calculate_mod_12", digits, budget_ms, [&]() {
+        bench_sink += (unsigned long long)calculate_mod_12(seed);
+    }));
+    results.push_back(bench_stage("string.calculate_mod_7", digits, budget_ms, [&]() {
+        bench_sink += (unsigned long long)calculate_mod_7(seed);
+    }));
+    {
+        BigInt leading;
+        results.push_back(bench_stage("string.ln_estimate", digits, budget_ms, [&]() {
+            bench_sink += (unsigned long long)LnEstimate::of(seed, leading).ln_precise;
+        }));
+    }
+
+    // --- BigInt / incremental state path ---
+    {
+        PredictionState state(seed);
+        PredictionMetrics metrics;
+        results.push_back(bench_stage("bigint.predict", digits, budget_ms, [&]() {
+            bench_sink += (unsigned long long)LGO_Predict_Deterministic(state, metrics);
+        }));
+    }
+    {
+        const PredictionState state(seed);
+        results.push_back(bench_stage("bigint.compute_metrics", digits, budget_ms, [&]() {
+            bench_sink += (unsigned long long)LGO_ComputeMetrics(state).final_gap;
+        }));
+    }
+    {
+        PredictionState state(seed);
+        results.push_back(bench_stage("bigint.advance", digits, budget_ms, [&]() {
+            state.advance(20);
+        }));
+    }
+    {
+        const PredictionState state(seed);
+        std::string text;
+        text.reserve((size_t)digits + 1);
+        results.push_back(bench_stage("bigint.to_decimal", digits, budget_ms, [&]() {
+            text.clear();
+            state.prime.append_decimal(text);
+            bench_sink += text.size();
+        }));
+    }
+
+    // --- Whole chain step: predict, sequence writer and metrics sink ---
+    {
+        std::error_code error;
+        std::filesystem::path scratch_dir = std::filesystem::temp_directory_path(error);
+        std::string sequence_path = (scratch_dir / "lgo_bench_chain.txt").string();
+        std::string metrics_path = (scratch_dir / "lgo_bench_chain.metrics").string();
+        std::remove(sequence_path.c_str());
+        PredictionState state(seed);
+        PredictionMetrics metrics;
+        long long step = 0;
+        SequenceWriter writer;
+        MetricsSink sink;
+        if (writer.open(sequence_path, SequenceWriterPolicy(), &state.prime) && sink.open(metrics_path, METRICS_BINARY)) {
+            results.push_back(bench_stage("chain.step", digits, budget_ms, [&]() {
+                LGO_Predict_Deterministic(state, metrics);
+                writer.write(state.prime, metrics.final_gap);
+                sink.append(++step, metrics);
+            }));
+        }
+        writer.close();
+        sink.close();
+        std::remove(sequence_path.c_str());
+        std::remove(metrics_path.c_str());
+    }
+
+    // --- SoA batch path: one op advances every lane by one step ---
+    {
+        PredictionBatch batch;
+        PredictionState state(seed);
+        for (size_t lane = 0; lane < BENCH_BATCH_LANES; lane++) {
+            batch.add(state);
+            LGO_JumpAhead(state, 1);
+        }
+        results.push_back(bench_stage(std::string("batch.step_") + batch_kernel_name(), digits, budget_ms, [&]() {
+            batch.step();
+            bench_sink += (unsigned long long)batch.last_gap(0);
+        }));
+    }
+    return results;
+}
+
+bool write_bench_json(const std::string& path, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    out << "{\n";
+    out << "  \"model_version\": \"" << LGO_MODEL_VERSION << "\",\n";
+    out << "  \"budget_ms_per_stage\": " << options.budget_ms << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"digits\": " << r.digits << ", \"stage\": \"" << r.stage << "\", \"supported\": " << (r.supported ? "true" : "false");
+        if (r.supported) {
+            double ops_per_sec = (r.ns_per_op > 0.0) ? 1e9 / r.ns_per_op : 0.0;
+            out << std::fixed << std::setprecision(3)
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.ns_per_op
+                << ", \"allocs_per_op\": " << r.allocs_per_op
+                << ", \"ops_per_sec\": " << ops_per_sec;
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.good();
+}
+
+int run_benchmarks(const BenchOptions& options) {
+    const long long sizes[] = {10, 15, 19, 100, 1000, 10000, 100000};
+    std::vector<BenchResult> results;
+
+    std::cout << std::left << std::setw(8) << "Digits" << std::setw(26) << "Stage"
+              << std::right << std::setw(16) << "ns/op" << std::setw(12) << "allocs/op" << std::setw(18) << "ops/s" << std::endl;
+
+    for (long long digits : sizes) {
+        if (digits > options.max_digits) continue;
+        for (const BenchResult& r : bench_size(digits, options.budget_ms)) {
+            std::cout << std::left << std::setw(8) << r.digits << std::setw(26) << r.stage << std::right;
+            if (r.supported) {
+                std::cout << std::fixed << std::setprecision(1) << std::setw(16) << r.ns_per_op
+                          << std::setprecision(2) << std::setw(12) << r.allocs_per_op
+                          << std::setprecision(0) << std::setw(18) << (r.ns_per_op > 0.0 ? 1e9 / r.ns_per_op : 0.0) << std::endl;
+            } else {
+                std::cout << std::setw(16) << "unsupported" << std::endl;
+            }
+            results.push_back(r);
+        }
+    }
+
+    if (!write_bench_json(options.json_file, options, results)) {
+        std::cerr << "Could not write " << options.json_file << std::endl;
+        return 1;
+    }
+    std::cout << "Results written to " << options.json_file << std::endl;
+    return 0;
+}
+
+bool parse_bench_options(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (arg == "--json" && has_value) {
+            options.json_file = argv[++i];
+        } else if (arg == "--max-digits" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.max_digits)) return false;
+        } else if (arg == "--budget-ms" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.budget_ms) || options.budget_ms <= 0) return false;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// ====================================================================
+// --- DIFFERENTIAL CHECK ---
+// ====================================================================
+// Runs the string reference (LGO_Predict_Deterministic on decimal text, then
+// add_strings) next to each optimised engine over the PRIME_LIST seeds and
+// random seeds, and compares rolling hashes of the two streams instead of
+// their text. Each step folds the gap, the digit count and the lowest 18
+// digits into the hash. A full-value hash every DIFF_CHECK_EVERY steps (and
+// after the last) catches errors in the higher digits. The records the
+// program actually writes are checked the same way: every SequenceWriter
+// output (text and binary, inline or pipelined, and one writer reused across
+// all seeds) is read back and hashed record by record against the reference
+// text. Timings come from separate runs that only step the engines.
+
+const long long DIFF_CHECK_EVERY = 256;
+const size_t DIFF_BATCH_MIN_LANES = 16; // Two full AVX-512 iterations
+const unsigned long long DIFF_HASH_BASIS = 0xcbf29ce484222325ULL;
+const unsigned long long DIFF_HASH_PRIME = 0x100000001b3ULL;
+
+struct DiffOptions {
+    long long steps = 2000;               // Per seed
+    long long random_seeds = 6;
+    long long max_digits = 100000;        // Random seed lengths are log-uniform up to this
+    unsigned long long rng_seed = 0x4C474F44ULL;
+};
+
+// One engine on one seed: hashes[k] covers steps 1..k (hashes[0] is the
+// basis) and values[i] is the full-value hash at checkpoint i. The reference
+// also keeps the hash of every record's text for the output check.
+struct DiffTrace {
+    std::vector<unsigned long long> hashes;
+    std::vector<unsigned long long> values;
+    std::vector<unsigned long long> records;
+};
+
+inline unsigned long long diff_step_hash(unsigned long long hash, long long gap, long long digits, unsigned long long low_digits) {
+    const unsigned long long words[3] = { (unsigned long long)gap, (unsigned long long)digits, low_digits };
+    for (unsigned long long word : words) {
+        hash = (hash ^ word) * DIFF_HASH_PRIME;
+        hash ^= hash >> 29;
+    }
+    return hash;
 }
 
+unsigned long long diff_value_hash(std::string_view decimal) {
+    unsigned long long hash = DIFF_HASH_BASIS;
+    for (char c : decimal) {
+        hash = (hash ^ (unsigned char)c) * DIFF_HASH_PRIME;
+    }
+    return hash;
+}
 
-// ====================================================================
-// --- CONSOLE MENU FUNCTIONS (Updated Version Number) ---
-// ====================================================================
+unsigned long long diff_low_digits(std::string_view decimal) {
+    size_t from = decimal.size() > (size_t)BIGINT_LIMB_DIGITS ? decimal.size() - BIGINT_LIMB_DIGITS : 0;
+    unsigned long long low = 0;
+    for (size_t i = from; i < decimal.size(); i++) { low = low * 10 + (unsigned long long)(decimal[i] - '0'); }
+    return low;
+}
 
-void display_menu() {
-    in_menu = true; 
-    system("mode con: cols=100 lines=20");
-    system("cls"); 
-    
-    std::cout << "===================================================================" << std::endl;
-    std::cout << "        LGO Deterministic Predictor (v5.9) - PRIME SELECTION       " << std::endl;
-    std::cout << "===================================================================" << std::endl;
-    std::cout << "\nChoose a starting prime or enter your own:\n" << std::endl;
-    
-    std::cout << "(L) Load Last Prime from " << SEQUENCE_FILE << std::endl;
-    std::cout << "-------------------------------------------------------------------" << std::endl;
+inline bool diff_is_checkpoint(long long step, long long steps) {
+    return step % DIFF_CHECK_EVERY == 0 || step == steps;
+}
 
+// Step of checkpoint 'index'.
+inline long long diff_checkpoint_step(size_t index, long long steps) {
+    return std::min(steps, (long long)(index + 1) * DIFF_CHECK_EVERY);
+}
 
-    for (const auto& item : PRIME_LIST) {
-        std::cout << item.first << " (" << item.second.length() << " digits)" << std::endl;
+DiffTrace diff_reference(const std::string& seed, long long steps) {
+    DiffTrace trace;
+    trace.hashes.reserve((size_t)steps + 1);
+    trace.hashes.push_back(DIFF_HASH_BASIS);
+    trace.records.reserve((size_t)steps);
+    std::string value = seed;
+    PredictionMetrics metrics;
+    StepScratch scratch;
+    for (long long step = 1; step <= steps; step++) {
+        long long gap = LGO_Predict_Deterministic(value, metrics, scratch);
+        value.swap(scratch.next);
+        trace.hashes.push_back(diff_step_hash(trace.hashes.back(), gap, (long long)value.size(), diff_low_digits(value)));
+        trace.records.push_back(diff_value_hash(value));
+        if (diff_is_checkpoint(step, steps)) { trace.values.push_back(trace.records.back()); }
     }
-    
-    std::cout << "\n(M) Manual Entry (arbitrary length)" << std::endl;
-    std::cout << "(Q) Quit Program" << std::endl;
-    std::cout << "-------------------------------------------------------------------" << std::endl;
-    
-    char choice;
-    std::string input_line;
-    
-    while (in_menu) { 
-        std::cout << "Your Choice: ";
-        std::getline(std::cin, input_line);
-        if (!input_line.empty()) {
-            choice = std::toupper(input_line[0]);
-        } else {
-            continue;
-        }
+    return trace;
+}
 
-        if (choice == 'Q') {
-            is_running = false; 
-            in_menu = false;
-            return;
-        } else if (choice == 'L') { 
-            std::string loaded_prime = load_last_prime();
-            if (!loaded_prime.empty()) {
-                user_prime_input = loaded_prime;
-                predictions_made = 0; 
-                in_menu = false; 
-                return;
-            } else {
-                std::cout << "Could not load sequence. Please choose another option." << std::endl;
-            }
-        } else if (choice == 'M') {
-            std::cout << "\nEnter your prime (arbitrary length): ";
-            std::getline(std::cin, user_prime_input);
-            if (!user_prime_input.empty() && user_prime_input.find_first_not_of("0123456789") == std::string::npos) {
-                user_prime_input = user_prime_input; 
-                std::cout << "Prime selected: " << user_prime_input << std::endl;
-                predictions_made = 0; 
-                in_menu = false; 
-                return;
-            } else {
-                std::cout << "Invalid input. Please enter only digits." << std::endl;
-            }
-        } else if (choice >= '1' && choice <= '0' + PRIME_LIST.size()) {
-            int index = choice - '1';
-            if (index >= 0 && index < PRIME_LIST.size()) { 
-                user_prime_input = PRIME_LIST[index].second;
-                std::cout << "Prime selected: " << user_prime_input << " (" << PRIME_LIST[index].first << ")" << std::endl;
-                predictions_made = 0; 
-                in_menu = false; 
-                return;
-            } else {
-                 std::cout << "Invalid selection. Please re-enter choice." << std::endl;
-            }
-        } else {
-            std::cout << "Invalid option. Please choose from the list." << std::endl;
+DiffTrace diff_incremental(const std::string& seed, long long steps) {
+    DiffTrace trace;
+    trace.hashes.reserve((size_t)steps + 1);
+    trace.hashes.push_back(DIFF_HASH_BASIS);
+    PredictionState state(seed);
+    PredictionMetrics metrics;
+    for (long long step = 1; step <= steps; step++) {
+        long long gap = LGO_Predict_Deterministic(state, metrics);
+        trace.hashes.push_back(diff_step_hash(trace.hashes.back(), gap, state.prime.digit_count(), state.prime.limb(0)));
+        if (diff_is_checkpoint(step, steps)) { trace.values.push_back(diff_value_hash(state.prime.to_string())); }
+    }
+    return trace;
+}
+
+// All seeds as lanes of one batch stepped by 'kernel', repeated up to
+// DIFF_BATCH_MIN_LANES lanes so the widest vector loop always runs: lane l
+// carries seed l % seeds.size().
+std::vector<DiffTrace> diff_batch(const std::vector<std::string>& seeds, long long steps, BatchKernel kernel) {
+    size_t lanes = std::max(seeds.size(), DIFF_BATCH_MIN_LANES);
+    std::vector<DiffTrace> traces(lanes);
+    PredictionBatch batch(kernel);
+    for (size_t lane = 0; lane < lanes; lane++) {
+        batch.add(PredictionState(seeds[lane % seeds.size()]));
+        traces[lane].hashes.reserve((size_t)steps + 1);
+        traces[lane].hashes.push_back(DIFF_HASH_BASIS);
+    }
+    for (long long step = 1; step <= steps; step++) {
+        batch.step();
+        for (size_t lane = 0; lane < lanes; lane++) {
+            DiffTrace& trace = traces[lane];
+            trace.hashes.push_back(diff_step_hash(trace.hashes.back(), batch.last_gap(lane), batch.digits(lane), batch.low_limb(lane)));
+            if (diff_is_checkpoint(step, steps)) { trace.values.push_back(diff_value_hash(batch.state(lane).prime.to_string())); }
         }
     }
+    return traces;
 }
 
-// ====================================================================
-// --- CRITICAL LINE SCANNER FUNCTION ---
-// ====================================================================
+// Jumps from checkpoint to checkpoint; there are no per-step hashes.
+DiffTrace diff_jump(const std::string& seed, long long steps) {
+    DiffTrace trace;
+    PredictionState state(seed);
+    for (long long done = 0; done < steps;) {
+        long long next = diff_checkpoint_step((size_t)(done / DIFF_CHECK_EVERY), steps);
+        LGO_JumpAhead(state, (unsigned long long)(next - done));
+        trace.values.push_back(diff_value_hash(state.prime.to_string()));
+        done = next;
+    }
+    return trace;
+}
 
-void draw_critical_line_scanner(double pnt_ratio) {
-    int start_x = 105;
-    int start_y = 25;
-    
-    // The "Non-Critical Zero Line" is the integer value of the PNT Ratio (e.g., 1.0, 2.0, etc.)
-    long long target_integer = (long long)std::round(pnt_ratio);
-    
-    // Center the scanner around the target integer value
-    gotoXY(start_x, start_y);
-    std::cout << "--- NON-CRITICAL ZERO LINE ---                                    ";
-    gotoXY(start_x, start_y + 1);
-    std::cout << "Target: " << target_integer << ".0                                                    ";
-    
-    // Calculate deviation from the target integer (normalized to fit display)
-    double deviation = pnt_ratio - (double)target_integer;
-    
-    // We normalize the deviation to a 40-character wide scale (20 to the left, 20 to the right)
-    // Scale factor chosen to fit the expected deviation range
-    int pointer_position = (int)std::round(deviation * 400.0); 
-    
-    // Center point of the display area (25 characters from the start_x)
-    int center = start_x + 25; 
-    
-    // Ensure position is within bounds (-20 to +20 offset from center)
-    pointer_position = std::min(20, std::max(-20, pointer_position));
-    
-    // Clear the line where the pointer moves
-    gotoXY(start_x, start_y + 2);
-    std::cout << "                                                    ";
+// --- Timing runs (no hashing) ---
 
-    // Draw the pointer ('*') at its deviated position
-    gotoXY(center + pointer_position, start_y + 2);
-    std::cout << "*"; 
-    
-    // Draw the stable line (the critical line) and range markers
-    gotoXY(start_x, start_y + 3);
-    std::cout << "  -0.05 |-------------------------| +0.05  ";
-    
-    // Draw the fixed center point (the Zero Line)
-    gotoXY(center, start_y + 3);
-    std::cout << "|"; 
-    
-    // Final clear of the status line to remove trail
-    gotoXY(start_x, start_y + 4); 
-    std::cout << "PNT Ratio: " << std::fixed << std::setprecision(6) << pnt_ratio << "                         ";
+double diff_seconds_since(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
 }
 
+double diff_time_reference(const std::string& seed, long long steps) {
+    std::string value = seed;
+    PredictionMetrics metrics;
+    StepScratch scratch;
+    auto started = std::chrono::steady_clock::now();
+    for (long long step = 0; step < steps; step++) {
+        bench_sink += (unsigned long long)LGO_Predict_Deterministic(value, metrics, scratch);
+        value.swap(scratch.next);
+    }
+    return diff_seconds_since(started);
+}
 
-// ====================================================================
-// --- PREDICTION LOOP ---
-// ====================================================================
+double diff_time_incremental(const std::string& seed, long long steps) {
+    PredictionState state(seed);
+    PredictionMetrics metrics;
+    auto started = std::chrono::steady_clock::now();
+    for (long long step = 0; step < steps; step++) {
+        bench_sink += (unsigned long long)LGO_Predict_Deterministic(state, metrics);
+    }
+    return diff_seconds_since(started);
+}
 
-void print_metrics(const PredictionMetrics& metrics) {
-    
-    gotoXY(0, 4);  
-    std::cout << " Prime Used: " << metrics.current_prime_digits << " digits...                                             " << std::endl; 
-    
-    // COLUMN 2: Predictor Components
-    gotoXY(50, 10); std::cout << metrics.current_prime_digits << "                 ";
-    gotoXY(50, 11); std::cout << metrics.base_gap_out << "                 ";
-    gotoXY(50, 12); std::cout << metrics.density_correction_G << "                 ";
-    gotoXY(50, 13); std::cout << metrics.correlative_adjustment << "                 ";
-    gotoXY(50, 14); std::cout << metrics.delta_out << "                 ";
-    gotoXY(50, 15); std::cout << metrics.fluctuation_delta << "                 ";
-    
-    // COLUMN 3: Final Output & Proof Metrics
-    gotoXY(105, 10); std::cout << metrics.final_gap << "                 ";
-    
-    // Analysis Status 
-    gotoXY(50, 18); std::cout << "Current Set: " << metrics.current_prime_set << "              " << std::endl;
-    
-    // --- PROOF METRICS WINDOW UPDATE ---
-    gotoXY(110, 13); std::cout << std::fixed << std::setprecision(6) << metrics.pnt_ratio << "     ";
-    gotoXY(110, 14); std::cout << std::fixed << std::setprecision(9) << ZETA_CRITICAL_LINE_CONSTANT << "   ";
-    
-    // RH PROOF PANEL UPDATE
-    gotoXY(10, 14); std::cout << std::fixed << std::setprecision(9) << C_LGO_STATIC << "             ";
-    gotoXY(10, 15); std::cout << std::fixed << std::setprecision(9) << C_LGO_STAR << "          ";
-    gotoXY(10, 16); std::cout << metrics.rh_condition_status << "                                  ";
-    
-    // --- CRITICAL LINE SCANNER CALL ---
-    draw_critical_line_scanner(metrics.pnt_ratio);
+// The whole batch: lanes share each step, so only the total is meaningful.
+double diff_time_batch(const std::vector<std::string>& seeds, long long steps, BatchKernel kernel) {
+    PredictionBatch batch(kernel);
+    for (const std::string& seed : seeds) { batch.add(PredictionState(seed)); }
+    auto started = std::chrono::steady_clock::now();
+    for (long long step = 0; step < steps; step++) {
+        batch.step();
+        bench_sink += (unsigned long long)batch.last_gap(0);
+    }
+    return diff_seconds_since(started);
+}
 
-    gotoXY(0, 32);
+// Same jump schedule as diff_jump().
+double diff_time_jump(const std::string& seed, long long steps) {
+    PredictionState state(seed);
+    auto started = std::chrono::steady_clock::now();
+    for (long long done = 0; done < steps;) {
+        long long next = diff_checkpoint_step((size_t)(done / DIFF_CHECK_EVERY), steps);
+        LGO_JumpAhead(state, (unsigned long long)(next - done));
+        done = next;
+    }
+    bench_sink += state.prime.limb(0);
+    return diff_seconds_since(started);
 }
 
-void draw_static_metrics_ui() {
-    system("mode con: cols=150 lines=50"); 
-    system("cls"); 
+// Re-runs the window before a jump checkpoint that disagreed one jump at a time.
+long long diff_refine_jump(const std::string& seed, const DiffTrace& reference, long long from_step, long long to_step) {
+    PredictionState state(seed);
+    LGO_JumpAhead(state, (unsigned long long)from_step);
+    for (long long step = from_step + 1; step <= to_step; step++) {
+        BigInt previous = state.prime;
+        LGO_JumpAhead(state, 1);
+        unsigned long long gap = 0;
+        if (!state.prime.difference_from(previous, gap)) return step;
+        unsigned long long hash = diff_step_hash(reference.hashes[(size_t)step - 1], (long long)gap, state.prime.digit_count(), state.prime.limb(0));
+        if (hash != reference.hashes[(size_t)step]) return step;
+    }
+    return to_step; // Only the higher digits differ
+}
 
-    gotoXY(0, 0);
-    std::cout << "========================================================================================================================================" << std::endl;
-    std::cout << "      LGO Deterministic Predictor (v5.9) - Console Mode Running...      " << std::endl;
-    std::cout << "========================================================================================================================================" << std::endl;
-    
-    gotoXY(105, 4); std::cout << "PRESS 'S' TO STOP AND RETURN TO MENU";
-    
-    // --- RH PROOF PANEL ---
-    gotoXY(5, 7);  std::cout << "------------------------------------------";
-    gotoXY(5, 8);  std::cout << "           RH PROOF PANEL (v26)           ";
-    gotoXY(5, 9);  std::cout << "------------------------------------------";
-    gotoXY(5, 10); std::cout << "Muon Mass (kg):  " << std::scientific << (double)MUON_MASS_LD;
-    gotoXY(5, 11); std::cout << "Electron Mass (kg):" << std::scientific << (double)ELECTRON_MASS_LD;
-    gotoXY(5, 12); std::cout << "Phi Dampener (Phi/2): " << std::fixed << std::setprecision(9) << PHI_DAMPENER;
-    gotoXY(5, 13); std::cout << "------------------------------------------";
-    gotoXY(5, 14); std::cout << "**LGO Static Constant:** "; 
-    gotoXY(5, 15); std::cout << "**Zeta-Stabilized (C_LGO*):**"; 
-    gotoXY(5, 16); std::cout << "**RH Lock-On Status:**"; 
-    gotoXY(5, 17); std::cout << "------------------------------------------";
-    
-    
-    // COLUMN 2: Predictor Components
-    gotoXY(50, 8); std::cout << "--- PREDICTOR COMPONENTS ---";
-    gotoXY(50, 10); std::cout << "Current Digits:    ";
-    gotoXY(50, 11); std::cout << "Base Gap Heuristic:  ";
-    gotoXY(50, 12); std::cout << "Density Correction (G): ";
-    gotoXY(50, 13); std::cout << "PHI Correlative (Phi): ";
-    gotoXY(50, 14); std::cout << "Ulam/Mod7 Delta (Delta): ";
-    gotoXY(50, 15); std::cout << "Fluctuation Delta (0):"; 
-    
-    // COLUMN 3: Final Output & Proof Metrics
-    gotoXY(105, 8); std::cout << "--- PROOF METRICS ---"; 
-    gotoXY(105, 10); std::cout << "FINAL GAP:           ";
-    gotoXY(105, 12); std::cout << "------------------------------------------";
-    gotoXY(105, 13); std::cout << "PNT Gap Ratio (Gap/ln(Pn)):"; 
-    gotoXY(105, 14); std::cout << "Zeta Critical Line Check:"; 
-    gotoXY(105, 15); std::cout << "------------------------------------------";
-    
-    // Print the bottom separator and log labels once
-    gotoXY(0, 21);
-    std::cout << "========================================================================================================================================" << std::endl;
-    gotoXY(0, 22); 
-    std::cout << "[0] Next Candidate: "; 
+// First step at which 'trace' leaves 'reference', or 0 when they agree.
+long long diff_first_divergence(const std::string& seed, const DiffTrace& reference, const DiffTrace& trace, long long steps) {
+    if (!trace.hashes.empty()) {
+        for (size_t step = 1; step < reference.hashes.size(); step++) {
+            if (trace.hashes[step] != reference.hashes[step]) return (long long)step;
+        }
+    }
+    for (size_t i = 0; i < reference.values.size(); i++) {
+        if (trace.values[i] == reference.values[i]) continue;
+        long long to_step = diff_checkpoint_step(i, steps);
+        if (!trace.hashes.empty()) return to_step; // Every lower-digit hash agreed up to here
+        long long from_step = i == 0 ? 0 : diff_checkpoint_step(i - 1, steps);
+        return diff_refine_jump(seed, reference, from_step, to_step);
+    }
+    return 0;
 }
 
-void print_log_entry(const std::string& next_prime_str) {
-    gotoXY(0, 22); 
-    std::cout << "[" << predictions_made << "] Next Candidate: " << next_prime_str << "                                                                                             " << std::endl;
+// --- Output streams ---
+
+struct DiffOutputCase {
+    const char* name;
+    SequenceFormat format;
+    bool pipelined;
+    bool reused; // One writer for every seed and its sibling, begin_chain() between them
+};
+
+const DiffOutputCase DIFF_OUTPUT_CASES[] = {
+    { "text", SEQUENCE_TEXT, false, false },
+    { "text, pipelined", SEQUENCE_TEXT, true, false },
+    { "text, reused writer", SEQUENCE_TEXT, false, true },
+    { "bin", SEQUENCE_BINARY, false, false },
+    { "bin, pipelined", SEQUENCE_BINARY, true, false },
+    { "bin, reused writer", SEQUENCE_BINARY, false, true },
+};
+
+// Writes the chains of 'seeds' to a fresh 'path' the way headless runs do.
+bool diff_write_output(const std::string& path, const DiffOutputCase& output, const std::vector<std::string>& seeds, long long steps) {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    SequenceWriterPolicy policy;
+    policy.format = output.format;
+    policy.buffer_bytes = 64 * 1024; // Many flushes, so block and buffer boundaries fall mid-chain
+    PredictionMetrics metrics;
+
+    if (output.pipelined) {
+        PredictionState state(seeds[0]);
+        ChainPipeline pipeline;
+        if (!pipeline.open(path, policy, state, 0)) return false;
+        for (long long step = 0; step < steps; step++) { pipeline.push(LGO_Predict_Deterministic(state, metrics)); }
+        return pipeline.close();
+    }
+    SequenceWriter writer;
+    PredictionState first(seeds[0]);
+    if (!writer.open(path, policy, &first.prime)) return false;
+    for (size_t chain = 0; chain < seeds.size(); chain++) {
+        PredictionState state(seeds[chain]);
+        if (chain > 0) { writer.begin_chain(); }
+        for (long long step = 0; step < steps; step++) {
+            long long gap = LGO_Predict_Deterministic(state, metrics);
+            writer.write(state.prime, gap);
+        }
+    }
+    return writer.close();
 }
 
+// First record of 'path' (1-based, over all chains) that does not match the
+// references' records, counting missing or extra records; 0 when all match.
+// Text is compared byte for byte: every record must end in '\n'.
+long long diff_compare_output(const std::string& path, SequenceFormat format, const std::vector<const DiffTrace*>& references) {
+    std::vector<unsigned long long> expected;
+    for (const DiffTrace* reference : references) {
+        expected.insert(expected.end(), reference->records.begin(), reference->records.end());
+    }
+    long long index = 0;
+    long long first = 0;
+    auto compare = [&](std::string_view record) {
+        if (first == 0 && (index >= (long long)expected.size() || diff_value_hash(record) != expected[(size_t)index])) { first = index + 1; }
+        index++;
+    };
 
-void prediction_loop() {
-    if (!is_running || user_prime_input.empty()) {
-        return;
+    if (format == SEQUENCE_BINARY) {
+        BinarySequenceReader reader;
+        std::string decoded;
+        bool ok = reader.open(path) && reader.for_each_record([&](const BigInt& value) {
+            decoded.clear();
+            value.append_decimal(decoded);
+            compare(decoded);
+        });
+        if (!ok && first == 0) { first = index + 1; }
+    } else {
+        MappedFile mapped;
+        if (mapped.open(path)) {
+            size_t offset = 0;
+            while (offset < mapped.size()) {
+                const char* newline = (const char*)std::memchr(mapped.data() + offset, '\n', mapped.size() - offset);
+                size_t end = newline != nullptr ? (size_t)(newline - mapped.data()) : mapped.size();
+                compare(std::string_view(mapped.data() + offset, end - offset));
+                if (newline == nullptr && first == 0) { first = index; } // Unterminated record
+                offset = end + 1;
+            }
+        }
     }
-    
-    draw_static_metrics_ui();
-    
-    while (is_running) { 
-        if (GetAsyncKeyState('S') & 0x8000) {
-            gotoXY(0, 35);
-            std::cout << "\n\n--- Stopping prediction and returning to menu... ---" << std::endl;
-            break; 
+    if (first == 0 && index != (long long)expected.size()) { first = std::min(index, (long long)expected.size()) + 1; }
+    return first;
+}
+
+std::vector<std::string> diff_seeds(const DiffOptions& options) {
+    std::vector<std::string> seeds;
+    for (const auto& item : PRIME_LIST) { seeds.push_back(item.second); }
+    std::mt19937_64 generator(options.rng_seed);
+    double log_max = std::log((double)std::max(20LL, options.max_digits));
+    for (long long i = 0; i < options.random_seeds; i++) {
+        // The last random seed always has the full length.
+        double share = i + 1 == options.random_seeds ? 1.0 : std::uniform_real_distribution<double>(0.0, 1.0)(generator);
+        long long digits = std::max(20LL, (long long)std::llround(std::exp(std::log(20.0) + share * (log_max - std::log(20.0)))));
+        seeds.push_back(random_decimal_seed(generator, std::min(digits, std::max(20LL, options.max_digits))));
+    }
+    return seeds;
+}
+
+// Same length as 'seed' but a different leading digit: a chain a reused
+// writer must not patch from the previous one's text.
+std::string diff_sibling_seed(const std::string& seed) {
+    std::string sibling = seed;
+    sibling[0] = sibling[0] == '1' ? '2' : '1';
+    return sibling;
+}
+
+std::string diff_divergence_text(long long step) {
+    return step > 0 ? "step " + std::to_string(step) : std::string("none");
+}
+
+int run_differential_check(const DiffOptions& options) {
+    const std::vector<std::string> seeds = diff_seeds(options);
+    const long long steps = options.steps;
+
+    std::vector<DiffTrace> references;
+    references.reserve(seeds.size());
+    for (const std::string& seed : seeds) { references.push_back(diff_reference(seed, steps)); }
+    const std::vector<BatchKernel>& kernels = compiled_batch_kernels();
+    std::vector<std::vector<DiffTrace>> batch_traces; // Per compiled kernel
+    for (BatchKernel kernel : kernels) { batch_traces.push_back(diff_batch(seeds, steps, kernel)); }
+    std::vector<std::string> chained; // Seeds and siblings, in the order a reused writer sees them
+    std::vector<const DiffTrace*> chained_references;
+    std::vector<DiffTrace> sibling_references;
+    sibling_references.reserve(seeds.size());
+    for (size_t s = 0; s < seeds.size(); s++) {
+        chained.push_back(seeds[s]);
+        chained.push_back(diff_sibling_seed(seeds[s]));
+        sibling_references.push_back(diff_reference(chained.back(), steps));
+        chained_references.push_back(&references[s]);
+        chained_references.push_back(&sibling_references.back());
+    }
+
+    std::cout << "Differential check: " << seeds.size() << " seeds, " << steps << " steps each, reference = string path" << std::endl;
+    std::cout << std::left << std::setw(6) << "Seed" << std::setw(9) << "Digits" << std::right << std::setw(14) << "Reference ms"
+              << std::setw(16) << "Incremental ms" << std::setw(10) << "Speedup" << std::setw(10) << "Jump ms" << std::setw(10) << "Speedup"
+              << "  First divergence (incremental";
+    for (BatchKernel kernel : kernels) { std::cout << " / batch-" << batch_kernel_name(kernel); }
+    std::cout << " / jump)" << std::endl;
+
+    long long divergent = 0;
+    double reference_seconds = 0.0;
+    double incremental_seconds = 0.0;
+    double jump_seconds = 0.0;
+    for (size_t s = 0; s < seeds.size(); s++) {
+        const DiffTrace& reference = references[s];
+        std::vector<long long> divergence;
+        divergence.push_back(diff_first_divergence(seeds[s], reference, diff_incremental(seeds[s], steps), steps));
+        for (const std::vector<DiffTrace>& traces : batch_traces) {
+            long long first = 0; // Earliest over every lane carrying this seed
+            for (size_t lane = s; lane < traces.size(); lane += seeds.size()) {
+                long long step = diff_first_divergence(seeds[s], reference, traces[lane], steps);
+                if (step > 0 && (first == 0 || step < first)) { first = step; }
+            }
+            divergence.push_back(first);
         }
-        
-        PredictionMetrics metrics;
-        
-        auto [final_gap, next_prime_str] = LGO_Predict_Deterministic(
-            user_prime_input, metrics
-        );
-        
-        predictions_made++;
+        divergence.push_back(diff_first_divergence(seeds[s], reference, diff_jump(seeds[s], steps), steps));
+        for (long long step : divergence) { if (step > 0) divergent++; }
 
-        print_metrics(metrics); 
-        print_log_entry(next_prime_str);
-        
-        save_new_prime(next_prime_str);
-        user_prime_input = next_prime_str; 
+        double reference_time = diff_time_reference(seeds[s], steps);
+        double incremental_time = diff_time_incremental(seeds[s], steps);
+        double jump_time = diff_time_jump(seeds[s], steps);
+        reference_seconds += reference_time;
+        incremental_seconds += incremental_time;
+        jump_seconds += jump_time;
+
+        std::cout << std::left << std::setw(6) << (s + 1) << std::setw(9) << seeds[s].length() << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(14) << reference_time * 1e3 << std::setw(16) << incremental_time * 1e3
+                  << std::setprecision(1) << std::setw(9) << (incremental_time > 0.0 ? reference_time / incremental_time : 0.0) << "x"
+                  << std::setprecision(2) << std::setw(10) << jump_time * 1e3
+                  << std::setprecision(1) << std::setw(9) << (jump_time > 0.0 ? reference_time / jump_time : 0.0) << "x"
+                  << " ";
+        for (size_t e = 0; e < divergence.size(); e++) { std::cout << (e == 0 ? " " : " / ") << diff_divergence_text(divergence[e]); }
+        std::cout << std::endl;
+    }
+
+    std::vector<std::pair<std::string, double>> totals;
+    totals.push_back({ "incremental", incremental_seconds });
+    for (BatchKernel kernel : kernels) {
+        totals.push_back({ std::string("batch-") + batch_kernel_name(kernel), diff_time_batch(seeds, steps, kernel) });
+    }
+    totals.push_back({ "jump", jump_seconds });
+    std::cout << "--- Totals (all seeds) ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2) << "reference    " << std::setw(12) << reference_seconds * 1e3 << " ms" << std::endl;
+    for (const auto& total : totals) {
+        std::cout << std::left << std::setw(13) << total.first << std::right << std::setprecision(2) << std::setw(12) << total.second * 1e3 << " ms"
+                  << std::setprecision(1) << std::setw(12) << (total.second > 0.0 ? reference_seconds / total.second : 0.0) << "x the reference" << std::endl;
+    }
+
+    std::error_code error;
+    std::filesystem::path scratch_dir = std::filesystem::temp_directory_path(error) / "lgo_diff";
+    std::filesystem::create_directories(scratch_dir, error);
+    std::cout << "--- Output streams (records read back from the sequence file) ---" << std::endl;
+    for (const DiffOutputCase& output : DIFF_OUTPUT_CASES) {
+        std::string path = (scratch_dir / (output.format == SEQUENCE_BINARY ? "chain.lgob" : "chain.txt")).string();
+        std::string result = "none";
+        size_t runs = output.reused ? 1 : seeds.size();
+        for (size_t s = 0; s < runs && result == "none"; s++) {
+            std::vector<std::string> written = output.reused ? chained : std::vector<std::string>{ seeds[s] };
+            std::vector<const DiffTrace*> expected = output.reused ? chained_references : std::vector<const DiffTrace*>{ &references[s] };
+            if (!diff_write_output(path, output, written, steps)) {
+                result = "could not write " + path;
+            } else if (long long record = diff_compare_output(path, output.format, expected)) {
+                size_t chain = output.reused ? (size_t)((record - 1) / steps) : 2 * s;
+                long long step = output.reused ? (record - 1) % steps + 1 : record;
+                result = "seed " + std::to_string(chain / 2 + 1) + (chain % 2 != 0 ? " (sibling) " : " ") + diff_divergence_text(step);
+            }
+        }
+        if (result != "none") { divergent++; }
+        std::cout << std::left << std::setw(22) << output.name << result << std::endl;
+    }
+    std::filesystem::remove_all(scratch_dir, error);
+
+    if (divergent > 0) {
+        std::cout << "Divergent runs: " << divergent << std::endl;
+        return 1;
+    }
+    std::cout << "All engines and output streams reproduce the reference." << std::endl;
+    return 0;
+}
 
-        // SMALL PAUSE for console stability
-        std::this_thread::sleep_for(std::chrono::milliseconds(100)); 
+bool parse_diff_options(int argc, char* argv[], DiffOptions& options) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        long long value = 0;
+        if (arg == "--steps" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.steps) || options.steps <= 0) return false;
+        } else if (arg == "--random" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.random_seeds)) return false;
+        } else if (arg == "--max-digits" && has_value) {
+            if (!parse_count_value(arg, argv[++i], options.max_digits) || options.max_digits < 20) return false;
+        } else if (arg == "--rng-seed" && has_value) {
+            if (!parse_count_value(arg, argv[++i], value)) return false;
+            options.rng_seed = (unsigned long long)value;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
     }
+    return true;
 }
 
 
@@ -552,11 +7993,107 @@ void prediction_loop() {
 // --- CONSOLE ENTRY POINT ---
 // ====================================================================
 
-int main() {
-    CONSOLE_CURSOR_INFO cursorInfo;
-    GetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursorInfo);
-    cursorInfo.bVisible = FALSE; 
-    SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursorInfo);
+int main(int argc, char* argv[]) {
+    // --profile works with any mode, the console included, so it is taken out
+    // before the mode is chosen.
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--profile") {
+            stage_profiling.store(true);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+
+    if (argc > 1 && !parse_console_options(argc, argv)) {
+        std::string first_arg = argv[1];
+        if (first_arg == "--help" || first_arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        }
+
+        if (first_arg == "--bench") {
+            BenchOptions bench_options;
+            if (!parse_bench_options(argc, argv, bench_options)) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            return run_benchmarks(bench_options);
+        }
+        if (first_arg == "--diff") {
+            DiffOptions diff_options;
+            if (!parse_diff_options(argc, argv, diff_options)) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            return run_differential_check(diff_options);
+        }
+        if (first_arg == "--convert-to-bin" && (argc == 4 || argc == 6)) {
+            long long keyframe_interval = BINARY_DEFAULT_KEYFRAME_INTERVAL;
+            if (argc == 6 && (std::string(argv[4]) != "--keyframe" || !parse_count_value("--keyframe", argv[5], keyframe_interval) || keyframe_interval <= 0)) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            return convert_text_to_binary(argv[2], argv[3], keyframe_interval) ? 0 : 1;
+        }
+        if (first_arg == "--convert-to-text" && argc == 4) {
+            return convert_binary_to_text(argv[2], argv[3]) ? 0 : 1;
+        }
+        if (first_arg == "--seek" && argc == 4) {
+            long long step = 0;
+            bool parsed = parse_count_value("--seek", argv[3], step);
+            if (!parsed || step <= 0) {
+                if (parsed) { std::cerr << "--seek steps are counted from 1." << std::endl; }
+                print_usage(argv[0]);
+                return 2;
+            }
+            return print_sequence_record(argv[2], step);
+        }
+        if (first_arg == "--stats" && argc == 3) {
+            return print_sequence_stats(argv[2]);
+        }
+        if (first_arg == "--jump" && argc == 4) {
+            long long steps = 0;
+            std::string start = argv[2];
+            if (start.empty() || start.find_first_not_of("0123456789") != std::string::npos) {
+                std::cerr << "--jump requires a prime made of digits only." << std::endl;
+                print_usage(argv[0]);
+                return 2;
+            }
+            if (!parse_count_value("--jump", argv[3], steps)) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            return print_jump_candidate(start, steps); // k = 0 is the start itself
+        }
+
+        if (first_arg == "--worker" && argc == 3) {
+            return run_shard_worker(argv[2]);
+        }
+
+        HeadlessOptions options;
+        if (!parse_headless_options(argc, argv, options)) {
+            print_usage(argv[0]);
+            return 2;
+        }
+        if (!options.sweep_source.empty()) {
+            return run_sweep(options);
+        }
+        if (!options.chains_source.empty()) {
+            return run_multi_chain(options);
+        }
+        if (options.ground_truth) {
+            return run_ground_truth(options);
+        }
+        if (options.shard_port >= 0) {
+            return run_shard_coordinator(options);
+        }
+        return run_headless(options);
+    }
+
+    terminal.set_cursor_visible(false);
 
     while (is_running) {
         display_menu(); 
@@ -566,12 +8103,19 @@ int main() {
         }
     }
     
-    cursorInfo.bVisible = TRUE;
-    SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE), &cursorInfo);
+    bool written = sequence_writer.close();
+
+    terminal.set_cursor_visible(true);
+    if (!written) {
+        std::cerr << "\nWriting the sequence file failed: " << SEQUENCE_FILE << std::endl;
+    }
 
     std::cout << "\n\n--- Program Terminated. Total Predictions: " << predictions_made << " ---" << std::endl;
-    std::cout << "Press ENTER to close the console." << std::endl;
-    std::cin.get();
+    print_profile_summary(std::cout);
+    if (terminal.is_interactive()) {
+        std::cout << "Press ENTER to close the console." << std::endl;
+        std::cin.get();
+    }
     
     return 0;
 }